@@ -1,4 +1,5 @@
 #include <arp/arp.hpp>
+#include <arp/format.hpp>
 
 #include <fmt/base.h>
 
@@ -20,7 +21,7 @@ auto main(int argc, const char** argv) -> int {
   };
 
   if (auto err = parser.parse(argc, argv))
-    fmt::println("error: '{}'", err->msg);
+    fmt::println("error: '{}'", *err);
 
   if (const auto& cmd = parser.get<"new">()) {
     fmt::println("name={} std={} git={} exe={} lib={} mod={} verbose={}",
@@ -0,0 +1,57 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace
+{
+
+bool run_file(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+
+  if (!in) {
+    std::fprintf(stderr, "error: cannot read '%s'\n", path.c_str());
+    return false;
+  }
+
+  std::vector<uint8_t> data(std::istreambuf_iterator<char>(in), {});
+  LLVMFuzzerTestOneInput(data.data(), data.size());
+  return true;
+}
+
+}
+
+/// Runs the fuzz target without libFuzzer, over each file argument and the
+/// files in each directory argument, such as the checked-in corpus. AFL can
+/// drive it with `afl-fuzz -i fuzz/corpus -o findings -- arp-fuzz-driver @@`,
+/// since a slow or mismatched parse aborts.
+auto main(int argc, const char** argv) -> int {
+  size_t inputs = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    std::error_code ec;
+
+    if (std::filesystem::is_directory(argv[i], ec)) {
+      for (const auto& entry: std::filesystem::directory_iterator(argv[i]))
+        if (entry.is_regular_file())
+          inputs += run_file(entry.path());
+    } else if (run_file(argv[i])) {
+      ++inputs;
+    } else {
+      return 1;
+    }
+  }
+
+  if (inputs == 0) {
+    std::fprintf(stderr, "usage: arp-fuzz-driver <input or directory>...\n");
+    return 1;
+  }
+
+  std::printf("ran %zu inputs\n", inputs);
+  return 0;
+}
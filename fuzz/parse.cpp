@@ -0,0 +1,194 @@
+#include "../tests/parse.hpp"
+
+#include <arp/arp.hpp>
+#include <arp/schema.hpp>
+#include <arp/validator.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+struct Config {
+  int number = 0;
+  double ratio = 0;
+  std::string_view name;
+  unsigned verbose = 0;
+  bool force = false;
+};
+
+/// Single-character flags, for long clusters in parse_single_type
+constexpr auto flags = [] {
+  using namespace arp;
+
+  return Parser{
+    Opt<'a', "all">(),
+    Opt<'b'>(),
+    Qty<'v', "verbose">(),
+    Qty<'q'>(),
+    Arg<'s', "std">({"17", "20", "23", "26"}),
+    Arg<'o', "output">(),
+    Arg<'j'>(),
+    MutEx{
+      Opt<'x', "exe">(),
+      Opt<'l', "lib">(),
+    },
+    Pos<"input">(),
+  };
+};
+
+/// Many positionals, each found by a scan in parse_pos
+constexpr auto positionals = [] {
+  using namespace arp;
+
+  return Parser{
+    Opt<'f', "force">(),
+    Pos<"p0">(), Pos<"p1">(), Pos<"p2">(), Pos<"p3">(),
+    Pos<"p4">(), Pos<"p5">(), Pos<"p6">(), Pos<"p7">(),
+    Pos<"p8">(), Pos<"p9">(), Pos<"p10">(), Pos<"p11">(),
+    Pos<"p12">(), Pos<"p13">(), Pos<"p14">(), Pos<"p15">(),
+  };
+};
+
+/// Subcommands nested five deep, each with its own keys
+constexpr auto nested = [] {
+  using namespace arp;
+
+  return Parser{
+    Opt<'v', "verbose">(),
+    Cmd<"a">(Parser{
+      Opt<'v', "verbose">(),
+      Cmd<"b">(Parser{
+        Arg<'k', "key">(),
+        Cmd<"c">(Parser{
+          Pos<"x">(),
+          Cmd<"d">(Parser{
+            Qty<'v', "verbose">(),
+            Cmd<"e">(Parser{
+              Pos<"y">(),
+              Arg<'k', "key">({"one", "two"}),
+            }),
+          }),
+        }),
+      }),
+    }),
+    Cmd<"z">(Parser{
+      Pos<"x">(),
+    }),
+  };
+};
+
+/// Values converted into the members of a Config
+constexpr auto bound = [] {
+  using namespace arp;
+
+  return Parser{
+    Arg<'n', "number">(bind<&Config::number>),
+    Arg<'r', "ratio">(bind<&Config::ratio>),
+    Qty<'v', "verbose">(bind<&Config::verbose>),
+    Opt<'f', "force">(bind<&Config::force>),
+    Pos<"name">(bind<&Config::name>),
+  };
+};
+
+/// The time allowed for one parse: a fixed allowance, plus a cost per byte
+/// of input that ARP_FUZZ_BUDGET may set in nanoseconds. A parse path whose
+/// cost grows faster than the input exceeds it once the input is long enough.
+double budget(size_t bytes) {
+  static const double per_byte = [] {
+    const char* env = std::getenv("ARP_FUZZ_BUDGET");
+    return env ? std::strtod(env, nullptr) : 250.0;
+  }();
+
+  return 100'000 + per_byte * static_cast<double>(bytes);
+}
+
+/// The fastest of a number of runs, so that one preemption is not mistaken
+/// for a slow parse
+template<class F>
+double time_ns(F&& fn, int runs) {
+  double best = 0;
+
+  for (int run = 0; run < runs; ++run) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    best = run ? std::min(best, ns) : ns;
+  }
+
+  return best;
+}
+
+template<class F>
+void check_budget(const char* schema, const char* stage, size_t bytes, F&& fn) {
+  if (time_ns(fn, 1) <= budget(bytes))
+    return;
+
+  if (double ns = time_ns(fn, 5); ns > budget(bytes)) {
+    std::fprintf(stderr, "%s: %s took %.0f ns for %zu bytes, over the budget of %.0f ns\n",
+      schema, stage, ns, bytes, budget(bytes));
+    std::abort();
+  }
+}
+
+/// Parse with the compiled parser and with the validator over its exported
+/// schema, each within the budget, and require both to report the same error
+template<auto F>
+void run(const char* schema, std::span<const char* const> args, size_t bytes) {
+  static const auto validator = arp::Validator::load(arp::schema<F>());
+
+  if (!validator) {
+    std::fprintf(stderr, "%s: exported schema does not load\n", schema);
+    std::abort();
+  }
+
+  std::optional<arp::ParserError> parsed, validated;
+
+  check_budget(schema, "parse", bytes, [&] { parsed = arp::test::parse<F, Config>(args); });
+  check_budget(schema, "validate", bytes, [&] { validated = validator->validate(args); });
+
+  if (!parsed != !validated
+      || (parsed && (parsed->err != validated->err
+                     || parsed->msg != validated->msg
+                     || parsed->index != validated->index
+                     || parsed->suggestion != validated->suggestion))) {
+    std::fprintf(stderr, "%s: parser reported '%s' at %zu, validator '%s' at %zu\n", schema,
+      parsed ? parsed->msg.c_str() : "nothing", parsed ? parsed->index : 0,
+      validated ? validated->msg.c_str() : "nothing", validated ? validated->index : 0);
+    std::abort();
+  }
+}
+
+}
+
+/// Each input is an argument array, one token per line or null-separated
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  std::string buffer(reinterpret_cast<const char*>(data), size);
+  std::vector<const char*> args;
+
+  for (size_t start = 0, end; start <= buffer.size(); start = end + 1) {
+    end = std::min(buffer.find_first_of(std::string_view("\n\0", 2), start), buffer.size());
+    buffer[end] = '\0';
+    args.push_back(buffer.data() + start);
+  }
+
+  // A trailing newline ends the last token rather than starting an empty one
+  if (size && (data[size - 1] == '\n' || data[size - 1] == '\0'))
+    args.pop_back();
+
+  run<flags>("flags", args, size);
+  run<positionals>("positionals", args, size);
+  run<nested>("nested", args, size);
+  run<bound>("bound", args, size);
+
+  return 0;
+}
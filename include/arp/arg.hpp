@@ -1,22 +1,21 @@
 #pragma once
 
+#include <arp/bind.hpp>
 #include <arp/id.hpp>
 #include <arp/meta.hpp>
-
-#include <fmt/format.h>
-#include <fmt/ranges.h>
+#include <arp/util.hpp>
 
 #include <array>
 #include <cstddef>
+#include <string>
 #include <string_view>
-#include <tuple>
 #include <utility>
 
 namespace arp
 {
 
-template<size_t N, Id... K> requires (sizeof...(K) != 0)
-struct ArgState final {
+template<size_t N, class B, Id... K> requires (sizeof...(K) != 0)
+struct ArgState {
   std::string_view value;
   std::array<const char*, N> choices;
 
@@ -25,35 +24,59 @@ struct ArgState final {
   {}
 };
 
-template<Id... K> requires (sizeof...(K) != 0)
-struct ArgState<0, K...> final {
+template<class B, Id... K> requires (sizeof...(K) != 0)
+struct ArgState<0, B, K...> {
   std::string_view value;
 };
 
+template<size_t N, auto M, Id... K>
+struct ArgState<N, Bind<M>, K...> {
+  using Binding = Bind<M>;
+  std::array<const char*, N> choices;
+
+  constexpr ArgState(std::array<const char*, N> choices)
+    : choices(std::move(choices))
+  {}
+};
+
+template<auto M, Id... K>
+struct ArgState<0, Bind<M>, K...> {
+  using Binding = Bind<M>;
+};
+
 template<Id... K>
-constexpr auto Arg() -> ArgState<0, K...> { return {}; }
+constexpr auto Arg() -> ArgState<0, Unbound, K...> { return {}; }
 
 template<Id... K, size_t N>
-constexpr auto Arg(const char* (&&choices)[N]) -> ArgState<N, K...> {
+constexpr auto Arg(const char* (&&choices)[N]) -> ArgState<N, Unbound, K...> {
+  return {std::to_array(choices)};
+}
+
+/// An Arg whose value is converted into a member of the parse target
+template<Id... K, auto M>
+constexpr auto Arg(Bind<M>) -> ArgState<0, Bind<M>, K...> { return {}; }
+
+template<Id... K, size_t N, auto M>
+constexpr auto Arg(const char* (&&choices)[N], Bind<M>) -> ArgState<N, Bind<M>, K...> {
   return {std::to_array(choices)};
 }
 
 template<class T> struct IsArg: std::false_type {};
-template<size_t N, Id... K> struct IsArg<ArgState<N, K...>>: std::true_type {};
+template<size_t N, class B, Id... K> struct IsArg<ArgState<N, B, K...>>: std::true_type {};
 
 template<class T> struct IsConstrainedArg: std::false_type {};
-template<Id... K> struct IsConstrainedArg<ArgState<0, K...>>: std::false_type {};
-template<size_t N, Id... K> struct IsConstrainedArg<ArgState<N, K...>>: std::true_type {};
+template<class B, Id... K> struct IsConstrainedArg<ArgState<0, B, K...>>: std::false_type {};
+template<size_t N, class B, Id... K> struct IsConstrainedArg<ArgState<N, B, K...>>: std::true_type {};
 
 }
 
 namespace arp
 {
 
-template<size_t N, Id... K>
-struct Meta<ArgState<N, K...>> final {
-  static constexpr auto id() {
-    return fmt::format("Arg<{}>", fmt::join(std::make_tuple(K.id()...), ", "));
+template<size_t N, class B, Id... K>
+struct Meta<ArgState<N, B, K...>> final: Keys<K...> {
+  static constexpr std::string id() {
+    return "Arg<" + join(", ", K.id()...) + ">";
   }
 
   static constexpr bool keyed_by(std::string_view key) {
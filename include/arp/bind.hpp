@@ -0,0 +1,66 @@
+#pragma once
+
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+
+namespace arp
+{
+
+template<class>
+struct MemberOf;
+
+template<class C, class V>
+struct MemberOf<V C::*> {
+  using Class = C;
+  using Type = V;
+};
+
+/// The binding of a node to a member of a user aggregate. A bound node
+/// stores its value in the member rather than in the node.
+template<auto M> requires std::is_member_object_pointer_v<decltype(M)>
+struct Bind final {
+  using Class = typename MemberOf<decltype(M)>::Class;
+  using Type = typename MemberOf<decltype(M)>::Type;
+
+  static constexpr Type& member(Class& target) {
+    return target.*M;
+  }
+};
+
+template<auto M>
+inline constexpr Bind<M> bind{};
+
+/// The binding of a node that stores its own value
+struct Unbound final {};
+
+template<class T> struct IsBinding: std::false_type {};
+template<auto M> struct IsBinding<Bind<M>>: std::true_type {};
+
+template<class T> struct IsBound: std::bool_constant<requires { typename T::Binding; }> {};
+
+/// Store a value in a bound member, converting it to the member's type.
+/// Returns false, leaving the member unchanged, if the value is not a valid
+/// representation of the type.
+template<class V>
+constexpr bool assign_value(V& member, std::string_view value) {
+  if constexpr (std::is_assignable_v<V&, std::string_view>) {
+    member = value;
+    return true;
+  } else {
+    static_assert(std::is_arithmetic_v<V> && !std::is_same_v<V, bool>, "unsupported member type");
+
+    // from_chars may write a value it then rejects, such as the prefix of a
+    // number followed by other characters
+    V converted{};
+    auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), converted);
+
+    if (ec != std::errc() || end != value.data() + value.size())
+      return false;
+
+    member = converted;
+    return true;
+  }
+}
+
+}
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <arp/handler.hpp>
 #include <arp/id.hpp>
 #include <arp/meta.hpp>
 
-#include <fmt/format.h>
-
+#include <array>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 namespace arp
@@ -13,13 +16,15 @@ namespace arp
 template<class... T>
 struct Parser;
 
-template<Id K, class... T>
+template<Id K, class F, class... T>
 struct CmdState final {
   Parser<T...> parser;
   bool invoked = false;
+  [[no_unique_address]] F handler;
 
-  constexpr CmdState(Parser<T...>&& parser)
+  constexpr CmdState(Parser<T...>&& parser, F handler = {})
     : parser(std::move(parser))
+    , handler(std::move(handler))
   {}
 
   constexpr operator bool() const {
@@ -33,22 +38,28 @@ struct CmdState final {
 };
 
 template<Id K, class... T>
-constexpr auto Cmd(Parser<T...>&& parser) -> CmdState<K, T...> {
+constexpr auto Cmd(Parser<T...>&& parser) -> CmdState<K, NoHandler, T...> {
   return {std::move(parser)};
 }
 
+/// A Cmd whose handler is invoked when parsing succeeds with the subcommand invoked
+template<Id K, class... T, class F>
+constexpr auto Cmd(Parser<T...>&& parser, F&& handler) -> CmdState<K, std::decay_t<F>, T...> {
+  return {std::move(parser), std::forward<F>(handler)};
+}
+
 template<class T> struct IsCmd: std::false_type {};
-template<Id K, class... T> struct IsCmd<CmdState<K, T...>>: std::true_type {};
+template<Id K, class F, class... T> struct IsCmd<CmdState<K, F, T...>>: std::true_type {};
 
 }
 
 namespace arp
 {
 
-template<Id K, class... T>
-struct Meta<CmdState<K, T...>> final {
-  static constexpr auto id() {
-    return fmt::format("Cmd<{}>", K.id());
+template<Id K, class F, class... T>
+struct Meta<CmdState<K, F, T...>> final: Keys<K> {
+  static constexpr std::string id() {
+    return "Cmd<" + std::string(K.id()) + ">";
   }
 
   static constexpr bool keyed_by(std::string_view key) {
@@ -59,6 +70,10 @@ struct Meta<CmdState<K, T...>> final {
   static consteval bool keyed_by() {
     return X == K;
   }
+
+  static constexpr std::string_view key() {
+    return K.id();
+  }
 };
 
 }
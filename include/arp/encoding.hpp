@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace arp
+{
+
+/// The binary schema encoding, written by arp/schema.hpp and read by
+/// arp/validator.hpp. Integers are little-endian.
+///
+///   schema  := magic version:u8 nodes
+///   nodes   := count:u16 node*
+///   node    := kind:u8 flags:u8 body
+///   body    := keys                (Opt, Qty)
+///            | keys type choices   (Arg)
+///            | keys type           (Pos)
+///            | keys nodes          (Cmd)
+///            | nodes               (MutEx)
+///   keys    := count:u16 string*
+///   choices := count:u16 string*
+///   type    := ValueType:u8 size:u8
+///   string  := size:u16 char*
+namespace encoding
+{
+
+inline constexpr std::array<uint8_t, 4> magic = {'A', 'R', 'P', 'S'};
+inline constexpr uint8_t version = 1;
+
+/// Set in a node's flags if the node is wrapped in Req
+inline constexpr uint8_t required = 1 << 0;
+
+enum class NodeKind: uint8_t {
+  opt = 1,
+  qty,
+  arg,
+  pos,
+  cmd,
+  mutex,
+};
+
+/// The type a value is converted to, with its size in bytes.
+/// The values of nodes that are not bound are strings.
+enum class ValueType: uint8_t {
+  string,
+  signed_integer,
+  unsigned_integer,
+  floating_point,
+};
+
+}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace arp
+{
+
+struct ParserError {
+  enum Enum {
+    invalid_argc,
+    invalid_value,
+    missing_value,
+    mutex_violation,
+    unknown_key,
+    unknown_pos,
+    unknown_value,
+  };
+
+  Enum err;
+  std::string msg;
+  size_t index = 0;  // Position of the offending token in the parsed arguments
+  std::string suggestion{};  // The nearest valid key or value to an unknown one, if any
+};
+
+/// A fixed-capacity list of errors, in the order they were found
+template<size_t N> requires (N != 0)
+class ParserErrors final {
+  std::array<ParserError, N> m_errors;
+  size_t m_size = 0;
+
+public:
+  void push(ParserError error) {
+    if (!full())
+      m_errors[m_size++] = std::move(error);
+  }
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  bool full() const { return m_size == N; }
+
+  ParserError& operator[](size_t index) { return m_errors[index]; }
+  const ParserError& operator[](size_t index) const { return m_errors[index]; }
+
+  auto begin() const { return m_errors.begin(); }
+  auto end() const { return m_errors.begin() + m_size; }
+};
+
+}
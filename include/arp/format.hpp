@@ -0,0 +1,52 @@
+#pragma once
+
+#include <arp/meta.hpp>
+#include <arp/parser.hpp>
+
+#include <fmt/format.h>
+
+#include <string_view>
+
+namespace arp
+{
+
+constexpr std::string_view name(ParserError::Enum err) {
+  switch (err) {
+    case ParserError::invalid_argc:    return "invalid_argc";
+    case ParserError::invalid_value:   return "invalid_value";
+    case ParserError::missing_value:   return "missing_value";
+    case ParserError::mutex_violation: return "mutex_violation";
+    case ParserError::unknown_key:     return "unknown_key";
+    case ParserError::unknown_pos:     return "unknown_pos";
+    case ParserError::unknown_value:   return "unknown_value";
+  }
+
+  return "unknown";
+}
+
+}
+
+template<>
+struct fmt::formatter<arp::ParserError::Enum>: fmt::formatter<std::string_view> {
+  auto format(arp::ParserError::Enum err, fmt::format_context& ctx) const {
+    return fmt::formatter<std::string_view>::format(arp::name(err), ctx);
+  }
+};
+
+template<>
+struct fmt::formatter<arp::ParserError>: fmt::formatter<std::string_view> {
+  auto format(const arp::ParserError& err, fmt::format_context& ctx) const {
+    if (err.suggestion.empty())
+      return fmt::formatter<std::string_view>::format(err.msg, ctx);
+
+    return fmt::formatter<std::string_view>::format(err.msg + " (did you mean '" + err.suggestion + "'?)", ctx);
+  }
+};
+
+/// Format any node by its identity, e.g. `Arg<s, std>`
+template<class T> requires requires { arp::Meta<T>::id(); }
+struct fmt::formatter<T>: fmt::formatter<std::string_view> {
+  auto format(const T&, fmt::format_context& ctx) const {
+    return fmt::formatter<std::string_view>::format(arp::Meta<T>::id(), ctx);
+  }
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <type_traits>
+
+namespace arp
+{
+
+/// The handler of a node that has none bound
+struct NoHandler final {};
+
+/// Invoke a node's handler with the node, or with no arguments
+/// if the handler does not accept one.
+template<class F, class Node>
+constexpr void invoke_handler(F& handler, Node& node) {
+  if constexpr (std::is_same_v<F, NoHandler>)
+    return;
+  else if constexpr (std::is_invocable_v<F&, Node&>)
+    handler(node);
+  else
+    handler();
+}
+
+}
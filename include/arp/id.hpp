@@ -25,4 +25,30 @@ struct Id final {
 
 Id(char) -> Id<2>;
 
+/// The keys of a node keyed by K..., for its Meta to inherit
+template<Id... K>
+struct Keys {
+  static constexpr std::array<std::string_view, sizeof...(K)> keys() {
+    return {K.id()...};
+  }
+
+  /// The node's first single-character key, or nothing if it has none
+  static constexpr std::string_view short_key() {
+    for (std::string_view key: {K.id()...})
+      if (key.size() == 1)
+        return key;
+
+    return {};
+  }
+
+  /// The node's first multi-character key, or nothing if it has none
+  static constexpr std::string_view long_key() {
+    for (std::string_view key: {K.id()...})
+      if (key.size() > 1)
+        return key;
+
+    return {};
+  }
+};
+
 }
@@ -7,9 +7,7 @@
 #include <arp/opt.hpp>
 #include <arp/qty.hpp>
 
-#include <fmt/format.h>
-#include <fmt/ranges.h>
-
+#include <string>
 #include <tuple>
 #include <type_traits>
 
@@ -35,8 +33,8 @@ namespace arp
 
 template<class... T>
 struct Meta<MutEx<T...>> final {
-  static constexpr auto id() {
-    return fmt::format("MutEx<{}>", fmt::join(std::make_tuple(Meta<T>::id()...), ", "));
+  static constexpr std::string id() {
+    return "MutEx<" + join(", ", Meta<T>::id()...) + ">";
   }
 
   static constexpr bool keyed_by(std::string_view key) {
@@ -1,36 +1,56 @@
 #pragma once
 
+#include <arp/bind.hpp>
+#include <arp/handler.hpp>
 #include <arp/id.hpp>
 #include <arp/meta.hpp>
+#include <arp/util.hpp>
 
-#include <fmt/format.h>
-#include <fmt/ranges.h>
-
+#include <array>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 
 namespace arp
 {
 
-template<Id... K> requires (sizeof...(K) != 0)
-struct OptState final {
+template<class F, Id... K> requires (sizeof...(K) != 0)
+struct OptState {
   bool status = false;
+  [[no_unique_address]] F handler;
+};
+
+template<auto M, Id... K>
+struct OptState<Bind<M>, K...> {
+  using Binding = Bind<M>;
 };
 
 template<Id... K>
-constexpr auto Opt() -> OptState<K...> { return {}; }
+constexpr auto Opt() -> OptState<NoHandler, K...> { return {}; }
+
+/// An Opt whose handler is invoked when parsing succeeds with the flag set
+template<Id... K, class F> requires (!IsBinding<std::decay_t<F>>::value)
+constexpr auto Opt(F&& handler) -> OptState<std::decay_t<F>, K...> {
+  return {.handler = std::forward<F>(handler)};
+}
+
+/// An Opt that sets a bool member of the parse target
+template<Id... K, auto M>
+constexpr auto Opt(Bind<M>) -> OptState<Bind<M>, K...> { return {}; }
 
 template<class T> struct IsOpt: std::false_type {};
-template<Id... K> struct IsOpt<OptState<K...>>: std::true_type {};
+template<class F, Id... K> struct IsOpt<OptState<F, K...>>: std::true_type {};
 
 }
 
 namespace arp
 {
 
-template<Id... K>
-struct Meta<OptState<K...>> final {
-  static constexpr auto id() {
-    return fmt::format("Opt<{}>", fmt::join(std::make_tuple(K.id()...), ", "));
+template<class F, Id... K>
+struct Meta<OptState<F, K...>> final: Keys<K...> {
+  static constexpr std::string id() {
+    return "Opt<" + join(", ", K.id()...) + ">";
   }
 
   static constexpr bool keyed_by(std::string_view key) {
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <arp/arg.hpp>
+#include <arp/bind.hpp>
 #include <arp/cmd.hpp>
+#include <arp/error.hpp>
 #include <arp/id.hpp>
 #include <arp/meta.hpp>
 #include <arp/mutex.hpp>
@@ -9,14 +11,13 @@
 #include <arp/pos.hpp>
 #include <arp/qty.hpp>
 #include <arp/req.hpp>
+#include <arp/suggest.hpp>
 #include <arp/tokens.hpp>
 #include <arp/util.hpp>
 
-#include <fmt/format.h>
-#include <fmt/ranges.h>
-
 #include <algorithm>
 #include <bitset>
+#include <expected>
 #include <functional>
 #include <optional>
 #include <span>
@@ -25,124 +26,502 @@
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace arp
 {
 
-struct ParserError {
-  enum Enum {
-    invalid_argc,
-    missing_value,
-    mutex_violation,
-    unknown_key,
-    unknown_pos,
-    unknown_value,
-  };
+template<class... T>
+class Snapshot;
 
-  Enum err;
-  std::string msg;
-};
+template<class... T>
+struct Changes;
 
 template<class... T>
 class Parser final {
+  template<class...> friend class Parser;
+  template<class...> friend class Snapshot;
+  template<class...> friend struct Changes;
+  friend struct Schema;
+
   std::tuple<T...> m_nodes;
   std::bitset<sizeof...(T)> m_parsed;
 
+  template<Id K>
+  static consteval bool contains();
+
+  template<class C>
+  static consteval bool bound_to();
+
 public:
-  Parser(T&&... nodes)
+  constexpr Parser(T&&... nodes)
     : m_nodes(std::forward_as_tuple(std::forward<T>(nodes)...))
   {}
 
-  /// Parse an array of tokenised arguments
-  std::optional<ParserError> parse(std::span<const char* const> args);
+  /// Parse an array of tokenised arguments. On success, the handlers
+  /// bound to set Opts and invoked Cmds are invoked.
+  std::optional<ParserError> parse(std::span<const char* const> args)
+    requires (bound_to<void>());
 
   /// Parse a program's 'main' args, including the executable
   /// path in the first position.
-  std::optional<ParserError> parse(int argc, const char** argv);
+  std::optional<ParserError> parse(int argc, const char** argv)
+    requires (bound_to<void>());
+
+  /// Parse an array of tokenised arguments, recording each error with the
+  /// index of its token and resuming at the next token, until `errors` is
+  /// full. Handlers are invoked only if there are no errors.
+  template<size_t N>
+  void parse(std::span<const char* const> args, ParserErrors<N>& errors)
+    requires (bound_to<void>());
+
+  /// Parse an array of tokenised arguments into `target`, the aggregate
+  /// whose members the parser's nodes are bound to. Bound nodes, including
+  /// those of subcommands, store their values only in `target`.
+  template<class C>
+  std::optional<ParserError> parse(std::span<const char* const> args, C& target)
+    requires (bound_to<C>());
+
+  /// Parse a program's 'main' args into `target`
+  template<class C>
+  std::optional<ParserError> parse(int argc, const char** argv, C& target)
+    requires (bound_to<C>());
+
+  /// Parse an array of tokenised arguments in place of the current result,
+  /// as `parse` does, and report which nodes changed. No handlers are
+  /// invoked, so the caller acts on the changes instead. On failure, the
+  /// current result is kept. The previous values refer to the previous
+  /// arguments, which must outlive the returned changes.
+  std::expected<Changes<T...>, ParserError> reparse(std::span<const char* const> args)
+    requires (bound_to<void>());
+
+  /// Clear the parse result
+  void reset();
 
   /// Obtain the node keyed by K from the parser
   template<Id K, class Self> requires (... || Meta<T>::template keyed_by<K>())
   constexpr auto&& get(this Self&&);
 
+  /// Write the parse result in canonical argv form, excluding the executable
+  /// path, as null-terminated tokens into `chars`, with a pointer to each in
+  /// `argv` followed by a null pointer. If keys are given, only the nodes
+  /// keyed by them are written, and bound nodes are never written, as their
+  /// values are not held by the parser. Returns the number of tokens written, or
+  /// nothing if a buffer is too small or the result cannot be represented, as
+  /// when a positional would be written without the positionals before it.
+  template<Id... K>
+  std::optional<size_t> emit(std::span<char> chars, std::span<const char*> argv) const
+    requires (... && contains<K>());
+
 private:
   template<Id K> requires (... || Meta<T>::template keyed_by<K>())
   static consteval size_t index();
 
-  std::optional<ParserError> parse_double_type(std::string_view token, std::span<const char* const>&);
-  std::optional<ParserError> parse_single_type(std::string_view token, std::span<const char* const>&);
-  std::optional<ParserError> parse_cmd_or_pos(std::string_view token, std::span<const char* const>&);
-  std::optional<ParserError> parse_pos(std::string_view token, std::span<const char* const>&);
+  template<class Node, Id K> requires (IsMutEx<Node>::value)
+  static consteval size_t group_index();
+
+  template<class C, class Node>
+  static consteval bool node_bound_to();
+
+  template<class Node>
+  static constexpr void long_keys(std::vector<std::string_view>&);
+
+  template<class Node>
+  static constexpr void command_keys(std::vector<std::string_view>&);
+
+  template<bool Commands>
+  static consteval auto suggestion_index();
+
+  static std::string suggest_key(std::string_view key);
+
+  static std::string suggest_command(std::string_view key);
+
+  template<class Node>
+  static std::string suggest_value(const Node&, std::string_view value);
+
+  template<class C, size_t N>
+  void parse_args(std::span<const char* const>, C* target, ParserErrors<N>&);
+
+  template<class C, size_t N>
+  void parse_tokens(std::span<const char* const>&, size_t argc, C* target, ParserErrors<N>&);
+
+  void invoke_handlers();
+
+  template<class To, class From>
+  static void assign(To&, const From&);
 
-  template<size_t K, class Node> requires (IsOpt<Node>::value || IsQty<Node>::value)
-  std::optional<ParserError> process_node(Node&);
+  template<class Other>
+  std::bitset<sizeof...(T)> diff(const Other&) const;
 
-  template<size_t K, class Node> requires (IsArg<Node>::value)
-  std::optional<ParserError> process_node(Node&, std::string_view value);
+  template<class Node>
+  static void reset_node(Node&);
 
-  template<size_t K, class Node, class F>
+  template<class Node, class To, class From>
+  static void assign_node(To&, const From&);
+
+  template<class Node, class Other>
+  static bool equal_nodes(const Node&, const Other&);
+
+  template<class Node, Id... K>
+  static consteval bool selected();
+
+  template<Id... K, class F>
+  void visit(F&& fn) const;
+
+  template<Id... K>
+  bool emit_tokens(TokenWriter&) const;
+
+  template<class C>
+  std::optional<ParserError> parse_double_type(const Token&, std::span<const char* const>&, C* target);
+  template<class C>
+  std::optional<ParserError> parse_single_type(std::string_view keys, std::span<const char* const>&, C* target);
+  template<class C, size_t N>
+  std::optional<ParserError> parse_cmd_or_pos(std::string_view token, std::span<const char* const>&, size_t argc, C* target, ParserErrors<N>&);
+  template<class C>
+  std::optional<ParserError> parse_pos(std::string_view token, C* target);
+
+  template<size_t K, class Node, class C> requires (IsOpt<Node>::value || IsQty<Node>::value)
+  std::optional<ParserError> process_node(Node&, C* target);
+
+  template<size_t K, class Node, class C> requires (IsArg<Node>::value)
+  std::optional<ParserError> process_node(Node&, std::string_view value, C* target);
+
+  template<class Node, class C> requires (IsArg<Node>::value || IsPos<Node>::value)
+  std::optional<ParserError> store_value(Node&, std::string_view value, C* target);
+
+  template<size_t K, class Node, class F, class C>
     requires std::is_invocable_r_v<std::optional<std::string_view>, F>
-  std::optional<ParserError> dispatch_node(Node&, std::string_view key, F&& consume_value);
+  std::optional<ParserError> dispatch_node(Node&, std::string_view key, F&& consume_value, C* target);
 };
 
+/// The parse result of a node: its status, count, value or invocation,
+/// without its keys, choices or handler
+template<class Node>
+struct NodeSnapshot {};
+
+template<class F, Id... K>
+struct NodeSnapshot<OptState<F, K...>> {
+  bool status = false;
+};
+
+template<class B, Id... K>
+struct NodeSnapshot<QtyState<B, K...>> {
+  size_t count = 0;
+};
+
+template<size_t N, class B, Id... K>
+struct NodeSnapshot<ArgState<N, B, K...>> {
+  std::string_view value;
+};
+
+template<Id K, class B>
+struct NodeSnapshot<PosState<K, B>> {
+  std::string_view value;
+};
+
+template<class T>
+struct NodeSnapshot<Req<T>>: NodeSnapshot<T> {};
+
 template<class... T>
-std::optional<ParserError> Parser<T...>::parse(std::span<const char* const> args) {
-  bool parsing_opts = true;
+struct NodeSnapshot<MutEx<T...>> {
+  std::tuple<NodeSnapshot<T>...> group;
+};
 
-  while (!args.empty()) {
-    std::string_view arg = args.front();
+template<Id K, class F, class... T>
+struct NodeSnapshot<CmdState<K, F, T...>> {
+  Snapshot<T...> parser;
+  bool invoked = false;
 
-    if (arg.empty())
-      std::ignore = consume_token(args);
+  constexpr operator bool() const {
+    return invoked;
+  }
 
-    if (!parsing_opts) {
-      if (auto key = consume_token(args);
-          auto err = parse_pos(key, args))
-        return *err;
-      continue;
-    }
+  template<Id X>
+  constexpr const auto& get() const {
+    return parser.template get<X>();
+  }
+};
 
-    if (try_consume_token("--", args)) {
-      parsing_opts = false;
-      continue;
-    }
+/// The parse result of a parser's nodes, and which of them were parsed.
+/// Unlike a copy of the parser, it holds no handlers, so it is copyable and
+/// assignable whatever the handlers capture.
+template<class... T>
+class Snapshot final {
+  template<class...> friend class Parser;
 
-    if (arg.size() > 2 && arg.starts_with("--")) {
-      if (auto key = consume_token(args);
-          auto err = parse_double_type(key, args))
-        return *err;
-      continue;
-    }
+  std::tuple<NodeSnapshot<T>...> m_nodes;
+  std::bitset<sizeof...(T)> m_parsed;
+
+public:
+  /// Obtain the result of the node keyed by K
+  template<Id K> requires (... || Meta<T>::template keyed_by<K>())
+  constexpr const auto& get() const;
+};
+
+/// The result of a reparse: the parse result as it was before, and which
+/// of the parser's nodes differ in the new result
+template<class... T>
+struct Changes final {
+  Snapshot<T...> previous;
+  std::bitset<sizeof...(T)> changed;
+
+  /// Whether the node keyed by K changed. For a key in a MutEx,
+  /// whether any node in the group changed.
+  template<Id K> requires (... || Meta<T>::template keyed_by<K>())
+  constexpr bool contains() const {
+    return changed[Parser<T...>::template index<K>()];
+  }
+
+  constexpr bool empty() const {
+    return changed.none();
+  }
+};
+
+template<class... T>
+std::optional<ParserError> Parser<T...>::parse(std::span<const char* const> args)
+  requires (bound_to<void>())
+{
+  ParserErrors<1> errors;
+
+  if (parse_args<void>(args, nullptr, errors); !errors.empty())
+    return std::move(errors[0]);
+
+  return std::nullopt;
+}
+
+template<class... T>
+template<size_t N>
+void Parser<T...>::parse(std::span<const char* const> args, ParserErrors<N>& errors)
+  requires (bound_to<void>())
+{
+  parse_args<void>(args, nullptr, errors);
+}
+
+template<class... T>
+template<class C>
+std::optional<ParserError> Parser<T...>::parse(std::span<const char* const> args, C& target)
+  requires (bound_to<C>())
+{
+  ParserErrors<1> errors;
+
+  if (parse_args(args, &target, errors); !errors.empty())
+    return std::move(errors[0]);
+
+  return std::nullopt;
+}
+
+template<class... T>
+template<class C>
+std::optional<ParserError> Parser<T...>::parse(int argc, const char** argv, C& target)
+  requires (bound_to<C>())
+{
+  if (argc <= 0)
+    return ParserError{
+      .err = ParserError::invalid_argc,
+      .msg = std::string("argc is ") + (!argc ? "zero" : "negative")
+    };
+
+  return parse({argv + 1, static_cast<size_t>(argc - 1)}, target);
+}
 
-    if (arg.size() > 1 && arg.starts_with('-')) {
-      if (auto key = consume_token(args);
-          auto err = parse_single_type(key, args))
-        return *err;
+template<class... T>
+template<class C, size_t N>
+void Parser<T...>::parse_args(std::span<const char* const> args, C* target, ParserErrors<N>& errors) {
+  if (parse_tokens(args, args.size(), target, errors); errors.empty())
+    invoke_handlers();
+}
+
+/// An error ends its token, so the rest of a flag cluster is skipped, but
+/// a value already consumed for an Arg is not read again as a token. Nested
+/// commands share the span, and argc is the size of the whole argument array,
+/// so a token's index is argc less the tokens remaining.
+template<class... T>
+template<class C, size_t N>
+void Parser<T...>::parse_tokens(std::span<const char* const>& args, size_t argc, C* target, ParserErrors<N>& errors) {
+  bool parsing_opts = true;
+
+  while (!args.empty() && !errors.full()) {
+    size_t index = argc - args.size();
+    std::string_view raw = consume_token(args);
+    std::optional<ParserError> error;
+
+    if (raw.empty())
       continue;
+
+    if (!parsing_opts) {
+      error = parse_pos(raw, target);
+    } else {
+      switch (Token token = classify_token(raw); token.kind) {
+        case Token::separator:
+          parsing_opts = false;
+          break;
+
+        case Token::long_key:
+          error = parse_double_type(token, args, target);
+          break;
+
+        case Token::short_keys:
+          error = parse_single_type(token.key, args, target);
+          break;
+
+        default:
+          error = parse_cmd_or_pos(raw, args, argc, target, errors);
+          break;
+      }
     }
 
-    if (auto key = consume_token(args);
-        auto err = parse_cmd_or_pos(key, args)) {
-      return *err;
+    if (error) {
+      error->index = index;
+      errors.push(std::move(*error));
     }
   }
 
   // validate_requirements();
   // validate_mutex_groups();
-
-  return std::nullopt;
 }
 
 template<class... T>
-std::optional<ParserError> Parser<T...>::parse(int argc, const char** argv) {
+std::optional<ParserError> Parser<T...>::parse(int argc, const char** argv)
+  requires (bound_to<void>())
+{
   if (argc <= 0)
     return ParserError{
       .err = ParserError::invalid_argc,
-      .msg = fmt::format("argc is {}", !argc ? "zero" : "negative")
+      .msg = std::string("argc is ") + (!argc ? "zero" : "negative")
     };
 
   return parse({argv + 1, static_cast<size_t>(argc - 1)});
 }
 
+template<class... T>
+auto Parser<T...>::reparse(std::span<const char* const> args) -> std::expected<Changes<T...>, ParserError>
+  requires (bound_to<void>())
+{
+  Changes<T...> changes;
+  ParserErrors<1> errors;
+  auto tokens = args;
+
+  assign(changes.previous, *this);
+  reset();
+
+  if (parse_tokens<void>(tokens, args.size(), nullptr, errors); !errors.empty()) {
+    assign(*this, changes.previous);
+    return std::unexpected(std::move(errors[0]));
+  }
+
+  changes.changed = diff(changes.previous);
+
+  return changes;
+}
+
+template<class... T>
+void Parser<T...>::reset() {
+  m_parsed.reset();
+
+  template_for(m_nodes, [&]<class Node>(Node& node) {
+    reset_node(node);
+  });
+}
+
+/// Copies a parse result between a parser and a snapshot of it
+template<class... T>
+template<class To, class From>
+void Parser<T...>::assign(To& to, const From& from) {
+  to.m_parsed = from.m_parsed;
+
+  template_for<sizeof...(T)>([&]<size_t K> {
+    using Node = std::tuple_element_t<K, std::tuple<T...>>;
+    assign_node<Node>(std::get<K>(to.m_nodes), std::get<K>(from.m_nodes));
+  });
+}
+
+/// A node that neither result has parsed holds its initial state in both,
+/// so only the nodes marked in either are compared.
+template<class... T>
+template<class Other>
+std::bitset<sizeof...(T)> Parser<T...>::diff(const Other& other) const {
+  std::bitset<sizeof...(T)> changed;
+  const auto parsed = m_parsed | other.m_parsed;
+
+  template_for<sizeof...(T)>([&, this]<size_t K> {
+    if (parsed[K])
+      changed[K] = !equal_nodes(std::get<K>(m_nodes), std::get<K>(other.m_nodes));
+  });
+
+  return changed;
+}
+
+template<class... T>
+template<class Node>
+void Parser<T...>::reset_node(Node& node) {
+  if constexpr (IsBound<Node>::value)
+    return;
+  else if constexpr (IsMutEx<Node>::value)
+    template_for(node.group, [&]<class MutExNode>(MutExNode& mutex_node) {
+      reset_node(mutex_node);
+    });
+  else if constexpr (IsOpt<Node>::value)
+    node.status = false;
+  else if constexpr (IsQty<Node>::value)
+    node.count = 0;
+  else if constexpr (IsArg<Node>::value || IsPos<Node>::value)
+    node.value = {};
+  else if constexpr (IsCmd<Node>::value) {
+    node.invoked = false;
+    node.parser.reset();
+  }
+}
+
+/// Copies the parse result of a node of type Node, either of which may be
+/// the node itself or its snapshot, as a node's handler may not be assignable
+template<class... T>
+template<class Node, class To, class From>
+void Parser<T...>::assign_node(To& to, const From& from) {
+  if constexpr (IsMutEx<Node>::value)
+    [&]<class... M, size_t... I>(std::type_identity<MutEx<M...>>, std::index_sequence<I...>) {
+      (..., assign_node<M>(std::get<I>(to.group), std::get<I>(from.group)));
+    }(std::type_identity<Node>(), std::make_index_sequence<std::tuple_size_v<decltype(from.group)>>());
+
+  if constexpr (IsOpt<Node>::value)
+    to.status = from.status;
+
+  if constexpr (IsQty<Node>::value)
+    to.count = from.count;
+
+  if constexpr (IsArg<Node>::value || IsPos<Node>::value)
+    to.value = from.value;
+
+  if constexpr (IsCmd<Node>::value) {
+    to.invoked = from.invoked;
+    std::remove_cvref_t<decltype(Node::parser)>::assign(to.parser, from.parser);
+  }
+}
+
+/// Arg and Pos values are compared by content, and a value that was given,
+/// even if empty, differs from one that was not
+template<class... T>
+template<class Node, class Other>
+bool Parser<T...>::equal_nodes(const Node& node, const Other& other) {
+  if constexpr (IsMutEx<Node>::value)
+    return [&]<size_t... M>(std::index_sequence<M...>) {
+      return (... && equal_nodes(std::get<M>(node.group), std::get<M>(other.group)));
+    }(std::make_index_sequence<std::tuple_size_v<decltype(node.group)>>());
+
+  if constexpr (IsOpt<Node>::value)
+    return node.status == other.status;
+
+  if constexpr (IsQty<Node>::value)
+    return node.count == other.count;
+
+  if constexpr (IsArg<Node>::value || IsPos<Node>::value)
+    return node.value == other.value && !node.value.data() == !other.value.data();
+
+  if constexpr (IsCmd<Node>::value)
+    return node.invoked == other.invoked && node.parser.diff(other.parser).none();
+
+  return true;
+}
+
 template<class... T>
 template<Id K, class Self> requires (... || Meta<T>::template keyed_by<K>())
 constexpr auto&& Parser<T...>::get(this Self&& self) {
@@ -151,28 +530,59 @@ constexpr auto&& Parser<T...>::get(this Self&& self) {
   using Node = std::tuple_element_t<X, std::tuple<T...>>;
   auto& node = std::get<X>(std::forward<Self>(self).m_nodes);
 
-  if constexpr (IsMutEx<Node>::value) {
-    constexpr size_t M = [&] {
-      size_t index = 0, found = 0;
+  if constexpr (IsMutEx<Node>::value)
+    return std::get<group_index<Node, K>()>(node.group);
 
-      template_for(node.group, [&]<class MutExNode>(MutExNode&) {
-        if constexpr (Meta<std::remove_cvref_t<MutExNode>>::template keyed_by<K>())
-          found = true;
+  if constexpr (!IsMutEx<Node>::value)
+    return node;
+}
 
-        if (!found)
-          index++;
-      });
+template<class... T>
+template<Id K> requires (... || Meta<T>::template keyed_by<K>())
+constexpr const auto& Snapshot<T...>::get() const {
+  constexpr size_t X = Parser<T...>::template index<K>();
 
-      return index;
-    }();
+  using Node = std::tuple_element_t<X, std::tuple<T...>>;
+  const auto& node = std::get<X>(m_nodes);
 
-    return std::get<M>(node.group);
-  }
+  if constexpr (IsMutEx<Node>::value)
+    return std::get<Parser<T...>::template group_index<Node, K>()>(node.group);
 
   if constexpr (!IsMutEx<Node>::value)
     return node;
 }
 
+/// Opt handlers are invoked before Cmd handlers, and the handlers of a
+/// subcommand's parser before the handler of its Cmd, so that a Cmd handler
+/// runs once every flag that configures it has been handled.
+template<class... T>
+void Parser<T...>::invoke_handlers() {
+  template_for(m_nodes, [&]<class Node>(Node& node) {
+    if constexpr (IsMutEx<Node>::value) {
+      template_for(node.group, [&]<class MutExNode>(MutExNode& mutex_node) {
+        if constexpr (IsOpt<MutExNode>::value && !IsBound<MutExNode>::value) {
+          if (mutex_node.status)
+            invoke_handler(mutex_node.handler, mutex_node);
+        }
+      });
+    }
+
+    if constexpr (IsOpt<Node>::value && !IsBound<Node>::value) {
+      if (node.status)
+        invoke_handler(node.handler, node);
+    }
+  });
+
+  template_for(m_nodes, [&]<class Node>(Node& node) {
+    if constexpr (IsCmd<Node>::value) {
+      if (node.invoked) {
+        node.parser.invoke_handlers();
+        invoke_handler(node.handler, node);
+      }
+    }
+  });
+}
+
 template<class... T>
 template<Id K> requires (... || Meta<T>::template keyed_by<K>())
 consteval size_t Parser<T...>::index() {
@@ -188,16 +598,275 @@ consteval size_t Parser<T...>::index() {
   return index;
 }
 
+/// The position in the MutEx group Node of the member keyed by K
 template<class... T>
-auto Parser<T...>::parse_double_type(std::string_view token, std::span<const char* const>& args) -> std::optional<ParserError> {
-  std::string_view key = token.substr(2);
-  std::optional<std::string_view> val;
+template<class Node, Id K> requires (IsMutEx<Node>::value)
+consteval size_t Parser<T...>::group_index() {
+  return []<class... M>(std::type_identity<MutEx<M...>>) {
+    size_t index = 0;
+    (void)(... || (Meta<M>::template keyed_by<K>() || (++index, false)));
+    return index;
+  }(std::type_identity<Node>());
+}
 
-  if (auto k = key.find('='); k != std::string_view::npos) {
-    val = key.substr(k + 1);
-    key = key.substr(0, k);
-  }
+template<class... T>
+template<Id K>
+consteval bool Parser<T...>::contains() {
+  return (... || Meta<T>::template keyed_by<K>());
+}
+
+/// Whether every bound node, including those in MutEx groups and
+/// subcommands, is bound to a member of C. If C is void, no node is bound.
+template<class... T>
+template<class C>
+consteval bool Parser<T...>::bound_to() {
+  return (... && node_bound_to<C, T>());
+}
+
+template<class... T>
+template<class C, class Node>
+consteval bool Parser<T...>::node_bound_to() {
+  if constexpr (IsMutEx<Node>::value)
+    return []<class... M>(std::type_identity<MutEx<M...>>) {
+      return (... && node_bound_to<C, M>());
+    }(std::type_identity<Node>());
+  else if constexpr (IsCmd<Node>::value)
+    return decltype(Node::parser)::template bound_to<C>();
+  else if constexpr (IsBound<Node>::value)
+    return std::is_same_v<typename Node::Binding::Class, C>;
+  else
+    return true;
+}
+
+/// The long keys of a node, which are the keys a misspelt long key is
+/// compared against. Short keys are not, as any two differ by one edit.
+template<class... T>
+template<class Node>
+constexpr void Parser<T...>::long_keys(std::vector<std::string_view>& keys) {
+  if constexpr (IsReq<Node>::value)
+    long_keys<typename Node::Type>(keys);
+  else if constexpr (IsMutEx<Node>::value)
+    []<class... M>(std::type_identity<MutEx<M...>>, auto& keys) {
+      (long_keys<M>(keys), ...);
+    }(std::type_identity<Node>(), keys);
+  else if constexpr (IsOpt<Node>::value || IsQty<Node>::value || IsArg<Node>::value)
+    for (std::string_view key: Meta<Node>::keys())
+      if (key.size() > 1 && key.size() <= max_suggestion_size)
+        keys.push_back(key);
+}
+
+/// The keys of a Cmd, which a word that is neither a subcommand nor a
+/// free positional is compared against
+template<class... T>
+template<class Node>
+constexpr void Parser<T...>::command_keys(std::vector<std::string_view>& keys) {
+  if constexpr (IsCmd<Node>::value)
+    if (Meta<Node>::key().size() <= max_suggestion_size)
+      keys.push_back(Meta<Node>::key());
+}
+
+template<class... T>
+template<bool Commands>
+consteval auto Parser<T...>::suggestion_index() {
+  constexpr auto keys = [] {
+    std::vector<std::string_view> keys;
+    (..., (Commands ? command_keys<T>(keys) : long_keys<T>(keys)));
+    return keys;
+  };
+
+  std::array<std::string_view, keys().size()> result;
+  std::ranges::copy(keys(), result.begin());
+  return SuggestionIndex(result);
+}
+
+/// Only called once a key is known to be unknown, so the index is
+/// never searched while parsing valid arguments
+template<class... T>
+std::string Parser<T...>::suggest_key(std::string_view key) {
+  static constexpr auto index = suggestion_index<false>();
+
+  if (auto suggestion = index.nearest(key); !suggestion.empty())
+    return "--" + std::string(suggestion);
+
+  return {};
+}
+
+template<class... T>
+std::string Parser<T...>::suggest_command(std::string_view key) {
+  static constexpr auto index = suggestion_index<true>();
+  return std::string(index.nearest(key));
+}
+
+/// Choices are only known at runtime, and are few, so they are scanned
+template<class... T>
+template<class Node>
+std::string Parser<T...>::suggest_value(const Node& node, std::string_view value) {
+  return std::string(nearest(node.choices, value));
+}
+
+template<class... T>
+template<class Node, Id... K>
+consteval bool Parser<T...>::selected() {
+  return sizeof...(K) == 0 || (... || Meta<Node>::template keyed_by<K>());
+}
+
+template<class... T>
+template<Id... K>
+std::optional<size_t> Parser<T...>::emit(std::span<char> chars, std::span<const char*> argv) const
+  requires (... && contains<K>())
+{
+  TokenWriter out(chars, argv);
+
+  if (!emit_tokens<K...>(out) || out.overflow())
+    return std::nullopt;
+
+  return out.count();
+}
+
+template<class... T>
+template<Id... K, class F>
+void Parser<T...>::visit(F&& fn) const {
+  template_for(m_nodes, [&]<class Node>(const Node& node) {
+    if constexpr (IsMutEx<Node>::value) {
+      template_for(node.group, [&]<class MutExNode>(const MutExNode& mutex_node) {
+        if constexpr (!IsBound<MutExNode>::value && selected<MutExNode, K...>())
+          fn(mutex_node);
+      });
+    } else if constexpr (!IsBound<Node>::value && selected<Node, K...>()) {
+      fn(node);
+    }
+  });
+}
+
+template<class... T>
+template<Id... K>
+bool Parser<T...>::emit_tokens(TokenWriter& out) const {
+  auto occurrences = []<class Node>(const Node& node) -> size_t {
+    if constexpr (IsOpt<Node>::value)
+      return node.status;
+
+    if constexpr (IsQty<Node>::value)
+      return node.count;
 
+    return 0;
+  };
+
+  bool cluster = false;
+  bool representable = true;
+
+  // Flags with a single-character key are combined, e.g. -gvvl. The cluster
+  // is begun only at its first flag, so that no flags write nothing at all.
+  visit<K...>([&]<class Node>(const Node& node) {
+    if constexpr (IsOpt<Node>::value || IsQty<Node>::value) {
+      if constexpr (!Meta<Node>::short_key().empty()) {
+        for (size_t n = occurrences(node); n > 0; --n) {
+          if (!cluster)
+            out.begin(), out.append('-'), cluster = true;
+
+          out.append(Meta<Node>::short_key());
+        }
+      }
+    }
+  });
+
+  if (cluster)
+    out.end();
+
+  visit<K...>([&]<class Node>(const Node& node) {
+    if constexpr (IsOpt<Node>::value || IsQty<Node>::value) {
+      if constexpr (Meta<Node>::short_key().empty()) {
+        for (size_t n = occurrences(node); n > 0; --n)
+          out.push("--", Meta<Node>::long_key());
+      }
+    }
+
+    if constexpr (IsArg<Node>::value) {
+      if (!node.value.data())
+        return;
+
+      // An empty value cannot follow -k=, but is read from the next token
+      if constexpr (!Meta<Node>::long_key().empty())
+        out.push("--", Meta<Node>::long_key(), "=", node.value);
+      else if (!node.value.empty())
+        out.push("-", Meta<Node>::short_key(), "=", node.value);
+      else
+        out.push("-", Meta<Node>::short_key()), out.push(node.value);
+    }
+  });
+
+  // Positionals are filled in order, so one cannot be written without every
+  // positional before it, which may be unselected or bound
+  bool skipped = false;
+
+  template_for<sizeof...(T)>([&, this]<size_t X> {
+    using Node = std::tuple_element_t<X, std::tuple<T...>>;
+
+    if constexpr (IsPos<Node>::value) {
+      constexpr bool written = !IsBound<Node>::value && selected<Node, K...>();
+
+      if (m_parsed[X] && !written)
+        skipped = true;
+      else if (m_parsed[X] && skipped)
+        representable = false;
+    }
+  });
+
+  // Positional values that would otherwise be read as keys or subcommands
+  // must follow '--', after which no subcommand can be invoked.
+  bool escape = false;
+  bool invoked = false;
+
+  visit<K...>([&]<class Node>(const Node& node) {
+    if constexpr (IsPos<Node>::value) {
+      if (!node.value.data())
+        return;
+
+      if (node.value.empty())
+        representable = false;
+
+      if (node.value.size() > 1 && node.value.starts_with('-'))
+        escape = true;
+
+      template_for(m_nodes, [&]<class Other>(const Other&) {
+        if constexpr (IsCmd<Other>::value)
+          escape = escape || Meta<Other>::keyed_by(node.value);
+      });
+    }
+
+    if constexpr (IsCmd<Node>::value)
+      invoked = invoked || node.invoked;
+  });
+
+  if (escape && invoked)
+    return false;
+
+  if (escape)
+    out.push("--");
+
+  visit<K...>([&]<class Node>(const Node& node) {
+    if constexpr (IsPos<Node>::value) {
+      if (node.value.data())
+        out.push(node.value);
+    }
+  });
+
+  visit<K...>([&]<class Node>(const Node& node) {
+    if constexpr (IsCmd<Node>::value) {
+      if (node.invoked) {
+        out.push(Meta<Node>::key());
+        representable = representable && node.parser.template emit_tokens<>(out);
+      }
+    }
+  });
+
+  return representable;
+}
+
+template<class... T>
+template<class C>
+auto Parser<T...>::parse_double_type(const Token& token, std::span<const char* const>& args, C* target) -> std::optional<ParserError> {
+  std::string_view key = token.key;
+  std::optional<std::string_view> val = token.value;
   bool match = false;
   std::optional<ParserError> error;
 
@@ -216,7 +885,7 @@ auto Parser<T...>::parse_double_type(std::string_view token, std::span<const cha
 
     return error = dispatch_node<K>(node, key, [&] {
       return val ? *val : try_consume_token(args);
-    });
+    }, target);
   });
 
   if (error)
@@ -225,15 +894,16 @@ auto Parser<T...>::parse_double_type(std::string_view token, std::span<const cha
   if (!match)
     return ParserError{
       .err = ParserError::unknown_key,
-      .msg = fmt::format("unknown key: {}", key)
+      .msg = "unknown key: " + std::string(key),
+      .suggestion = suggest_key(key)
     };
 
   return std::nullopt;
 }
 
 template<class... T>
-auto Parser<T...>::parse_single_type(std::string_view token, std::span<const char* const>& args) -> std::optional<ParserError> {
-  std::string_view keys = token.substr(1);
+template<class C>
+auto Parser<T...>::parse_single_type(std::string_view keys, std::span<const char* const>& args, C* target) -> std::optional<ParserError> {
   bool value_consumed = false;
 
   while (!value_consumed && !keys.empty()) {
@@ -265,7 +935,7 @@ auto Parser<T...>::parse_single_type(std::string_view token, std::span<const cha
 
       return error = dispatch_node<K>(node, key, [&] {
         return value_consumed = true, val ? *val : try_consume_token(args);
-      });
+      }, target);
     });
 
     if (error)
@@ -274,7 +944,7 @@ auto Parser<T...>::parse_single_type(std::string_view token, std::span<const cha
     if (!match)
       return ParserError{
         .err = ParserError::unknown_key,
-        .msg = fmt::format("unknown key: {}", key)
+        .msg = "unknown key: " + std::string(key)
       };
 
     keys.remove_prefix(1);
@@ -284,42 +954,48 @@ auto Parser<T...>::parse_single_type(std::string_view token, std::span<const cha
 }
 
 template<class... T>
-auto Parser<T...>::parse_cmd_or_pos(std::string_view token, std::span<const char* const>& args) -> std::optional<ParserError> {
+template<class C, size_t N>
+auto Parser<T...>::parse_cmd_or_pos(std::string_view token, std::span<const char* const>& args, size_t argc, C* target, ParserErrors<N>& errors) -> std::optional<ParserError> {
   std::string_view key = token;
-  std::optional<ParserError> error;
   bool match = false;
 
-  template_for<sizeof...(T)>([&, this]<size_t K> -> std::optional<ParserError> {
+  template_for<sizeof...(T)>([&, this]<size_t K> {
     using Node = std::tuple_element_t<K, std::tuple<T...>>;
     Node& node = std::get<K>(m_nodes);
 
-    if (match || error)
-      return std::nullopt;
+    if (match)
+      return;
 
     if constexpr (IsCmd<Node>::value) {
       if (match = Meta<Node>::keyed_by(key); !match)
-        return std::nullopt;
+        return;
+
+      // The subcommand's parser records its own errors
+      size_t count = errors.size();
 
-      if (error = node.parser.parse(consume_all(args)); !error) {
+      if (node.parser.parse_tokens(args, argc, target, errors); errors.size() == count) {
         node.invoked = true;
         m_parsed[K] = true;
       }
     }
-
-    return error;
   });
 
-  if (error)
-    return *error;
-
   if (match)
     return std::nullopt;
 
-  return parse_pos(token, args);
+  // A word that fills no positional may be a misspelt subcommand
+  auto error = parse_pos(token, target);
+
+  if (error && error->err == ParserError::unknown_pos)
+    error->suggestion = suggest_command(token);
+
+  return error;
 }
 
 template<class... T>
-auto Parser<T...>::parse_pos(std::string_view token, std::span<const char* const>& args) -> std::optional<ParserError> {
+template<class C>
+auto Parser<T...>::parse_pos(std::string_view token, C* target) -> std::optional<ParserError> {
+  std::optional<ParserError> error;
   bool match = false;
 
   template_for<sizeof...(T)>([&, this]<size_t K> {
@@ -333,56 +1009,83 @@ auto Parser<T...>::parse_pos(std::string_view token, std::span<const char* const
       if (!m_parsed[K]) {
         match = true;
         m_parsed[K] = true;
-        node.value = token;
+        error = store_value(node, token, target);
       }
     }
   });
 
+  if (error)
+    return *error;
+
   if (!match)
     return ParserError{
       .err = ParserError::unknown_pos,
-      .msg = fmt::format("unknown positional argument: {}", token)
+      .msg = "unknown positional argument: " + std::string(token)
     };
 
   return std::nullopt;
 }
 
 template<class... T>
-template<size_t K, class Node> requires (IsOpt<Node>::value || IsQty<Node>::value)
-auto Parser<T...>::process_node(Node& node) -> std::optional<ParserError> {
+template<size_t K, class Node, class C> requires (IsOpt<Node>::value || IsQty<Node>::value)
+auto Parser<T...>::process_node(Node& node, C* target) -> std::optional<ParserError> {
   m_parsed[K] = true;
 
-  if constexpr (IsOpt<Node>::value)
+  if constexpr (IsOpt<Node>::value && IsBound<Node>::value)
+    Node::Binding::member(*target) = true;
+  else if constexpr (IsOpt<Node>::value)
     node.status = true;
 
-  if constexpr (IsQty<Node>::value)
+  if constexpr (IsQty<Node>::value && IsBound<Node>::value)
+    Node::Binding::member(*target) += 1;
+  else if constexpr (IsQty<Node>::value)
     node.count += 1;
 
   return std::nullopt;
 }
 
 template<class... T>
-template<size_t K, class Node> requires (IsArg<Node>::value)
-auto Parser<T...>::process_node(Node& node, std::string_view value) -> std::optional<ParserError> {
+template<size_t K, class Node, class C> requires (IsArg<Node>::value)
+auto Parser<T...>::process_node(Node& node, std::string_view value, C* target) -> std::optional<ParserError> {
   m_parsed[K] = true;
 
   if constexpr (IsConstrainedArg<Node>::value) {
     if (!std::ranges::contains(node.choices, value))
       return ParserError{
         .err = ParserError::unknown_value,
-        .msg = fmt::format("value '{}' not in choices list: {}", value, node.choices)
+        .msg = std::apply([&](auto... choice) {
+          return "value '" + std::string(value) + "' not in choices list: ["
+            + join(", ", "\"" + std::string(choice) + "\""...) + "]";
+        }, node.choices),
+        .suggestion = suggest_value(node, value)
       };
   }
 
-  node.value = value;
+  return store_value(node, value, target);
+}
+
+/// A bound node's value is converted to the type of its member,
+/// which is left unchanged if the value is invalid
+template<class... T>
+template<class Node, class C> requires (IsArg<Node>::value || IsPos<Node>::value)
+auto Parser<T...>::store_value(Node& node, std::string_view value, C* target) -> std::optional<ParserError> {
+  if constexpr (IsBound<Node>::value) {
+    if (!assign_value(Node::Binding::member(*target), value))
+      return ParserError{
+        .err = ParserError::invalid_value,
+        .msg = "value '" + std::string(value) + "' not valid for " + Meta<Node>::id()
+      };
+  } else {
+    node.value = value;
+  }
 
   return std::nullopt;
 }
 
 template<class... T>
-template<size_t K, class Node, class F>
+template<size_t K, class Node, class F, class C>
   requires std::is_invocable_r_v<std::optional<std::string_view>, F>
-auto Parser<T...>::dispatch_node(Node& node, std::string_view key, F&& consume_value) -> std::optional<ParserError> {
+auto Parser<T...>::dispatch_node(Node& node, std::string_view key, F&& consume_value, C* target) -> std::optional<ParserError> {
   if constexpr (IsMutEx<Node>::value) {
     std::optional<ParserError> error;
 
@@ -391,7 +1094,7 @@ auto Parser<T...>::dispatch_node(Node& node, std::string_view key, F&& consume_v
         return std::nullopt;
 
       return Meta<std::remove_cvref_t<MutExNode>>::keyed_by(key)
-        ? error = dispatch_node<K>(mutex_node, key, std::forward<F>(consume_value))
+        ? error = dispatch_node<K>(mutex_node, key, std::forward<F>(consume_value), target)
         : std::nullopt;
     });
 
@@ -399,7 +1102,7 @@ auto Parser<T...>::dispatch_node(Node& node, std::string_view key, F&& consume_v
   }
 
   if constexpr (IsOpt<Node>::value || IsQty<Node>::value)
-    return process_node<K>(node);
+    return process_node<K>(node, target);
 
   if constexpr (IsArg<Node>::value) {
     auto value = std::invoke(consume_value);
@@ -407,10 +1110,10 @@ auto Parser<T...>::dispatch_node(Node& node, std::string_view key, F&& consume_v
     if (!value)
       return ParserError{
         .err = ParserError::missing_value,
-        .msg = fmt::format("value not supplied for arg '{}'", key)
+        .msg = "value not supplied for arg '" + std::string(key) + "'"
       };
 
-    return process_node<K>(node, *value);
+    return process_node<K>(node, *value, target);
   }
 
   throw std::runtime_error("unhandled node");
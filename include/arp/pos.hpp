@@ -1,33 +1,44 @@
 #pragma once
 
+#include <arp/bind.hpp>
 #include <arp/id.hpp>
 #include <arp/meta.hpp>
 
-#include <fmt/format.h>
+#include <array>
+#include <string>
 
 namespace arp
 {
 
-template<Id K>
-struct PosState final {
+template<Id K, class B = Unbound>
+struct PosState {
   std::string_view value;
 };
 
+template<Id K, auto M>
+struct PosState<K, Bind<M>> {
+  using Binding = Bind<M>;
+};
+
 template<Id K>
 constexpr auto Pos() -> PosState<K> { return {}; }
 
+/// A Pos whose value is converted into a member of the parse target
+template<Id K, auto M>
+constexpr auto Pos(Bind<M>) -> PosState<K, Bind<M>> { return {}; }
+
 template<class T> struct IsPos: std::false_type {};
-template<Id K> struct IsPos<PosState<K>>: std::true_type {};
+template<Id K, class B> struct IsPos<PosState<K, B>>: std::true_type {};
 
 }
 
 namespace arp
 {
 
-template<Id K>
-struct Meta<PosState<K>> final {
-  static constexpr auto id() {
-    return fmt::format("Pos<{}>", K.id());
+template<Id K, class B>
+struct Meta<PosState<K, B>> final: Keys<K> {
+  static constexpr std::string id() {
+    return "Pos<" + std::string(K.id()) + ">";
   }
 
   static constexpr bool keyed_by(std::string_view key) {
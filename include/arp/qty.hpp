@@ -1,37 +1,48 @@
 #pragma once
 
+#include <arp/bind.hpp>
 #include <arp/id.hpp>
 #include <arp/meta.hpp>
+#include <arp/util.hpp>
 
-#include <fmt/format.h>
-#include <fmt/ranges.h>
-
+#include <array>
 #include <cstddef>
+#include <string>
+#include <string_view>
 #include <type_traits>
 
 namespace arp
 {
 
-template<Id... K> requires (sizeof...(K) != 0)
-struct QtyState final {
+template<class B, Id... K> requires (sizeof...(K) != 0)
+struct QtyState {
   size_t count = 0;
 };
 
+template<auto M, Id... K>
+struct QtyState<Bind<M>, K...> {
+  using Binding = Bind<M>;
+};
+
 template<Id... K>
-constexpr auto Qty() -> QtyState<K...> { return {}; }
+constexpr auto Qty() -> QtyState<Unbound, K...> { return {}; }
+
+/// A Qty that increments an integral member of the parse target
+template<Id... K, auto M>
+constexpr auto Qty(Bind<M>) -> QtyState<Bind<M>, K...> { return {}; }
 
 template<class T> struct IsQty: std::false_type {};
-template<Id... K> struct IsQty<QtyState<K...>>: std::true_type {};
+template<class B, Id... K> struct IsQty<QtyState<B, K...>>: std::true_type {};
 
 }
 
 namespace arp
 {
 
-template<Id... K>
-struct Meta<QtyState<K...>> final {
-  static constexpr auto id() {
-    return fmt::format("Qty<{}>", fmt::join(std::make_tuple(K.id()...), ", "));
+template<class B, Id... K>
+struct Meta<QtyState<B, K...>> final: Keys<K...> {
+  static constexpr std::string id() {
+    return "Qty<" + join(", ", K.id()...) + ">";
   }
 
   static constexpr bool keyed_by(std::string_view key) {
@@ -1,22 +1,42 @@
 #pragma once
 
+#include <arp/arg.hpp>
 #include <arp/id.hpp>
 #include <arp/meta.hpp>
+#include <arp/opt.hpp>
+#include <arp/pos.hpp>
+#include <arp/qty.hpp>
 
-#include <fmt/format.h>
+#include <string>
+#include <string_view>
+#include <utility>
 
 namespace arp
 {
 
-template<class T>
+/// A node marked as required. It parses as the node it wraps, and is
+/// exported with the required flag, but is not yet enforced.
+template<class T> requires (IsOpt<T>::value || IsQty<T>::value || IsArg<T>::value || IsPos<T>::value)
 struct Req: T {
-  using T::T;
   using Type = T;
+
+  constexpr Req(T node)
+    : T(std::move(node))
+  {}
 };
 
+template<class T>
+Req(T) -> Req<T>;
+
 template<class T> struct IsReq: std::false_type {};
 template<class T> struct IsReq<Req<T>>: std::true_type {};
 
+template<class T> struct IsOpt<Req<T>>: IsOpt<T> {};
+template<class T> struct IsQty<Req<T>>: IsQty<T> {};
+template<class T> struct IsArg<Req<T>>: IsArg<T> {};
+template<class T> struct IsConstrainedArg<Req<T>>: IsConstrainedArg<T> {};
+template<class T> struct IsPos<Req<T>>: IsPos<T> {};
+
 }
 
 namespace arp
@@ -24,8 +44,20 @@ namespace arp
 
 template<class T>
 struct Meta<Req<T>> final {
-  static constexpr auto id() {
-    return fmt::format("Req<{}>", Meta<T>::id());
+  static constexpr std::string id() {
+    return "Req<" + Meta<T>::id() + ">";
+  }
+
+  static constexpr auto keys() {
+    return Meta<T>::keys();
+  }
+
+  static constexpr std::string_view short_key() {
+    return Meta<T>::short_key();
+  }
+
+  static constexpr std::string_view long_key() {
+    return Meta<T>::long_key();
   }
 
   static constexpr bool keyed_by(std::string_view key) {
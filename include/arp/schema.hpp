@@ -0,0 +1,274 @@
+#pragma once
+
+#include <arp/bind.hpp>
+#include <arp/encoding.hpp>
+#include <arp/meta.hpp>
+#include <arp/parser.hpp>
+#include <arp/req.hpp>
+#include <arp/util.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace arp
+{
+
+/// Walks a parser tree in declaration order, describing each node to a writer
+struct Schema final {
+  template<class W, class... T>
+  static constexpr void write(W& out, const Parser<T...>& parser) {
+    out.nodes(sizeof...(T));
+
+    template_for(parser.m_nodes, [&]<class Node>(const Node& node) {
+      write(out, node, 0);
+    });
+
+    out.end_nodes();
+  }
+
+  template<class W, class Node>
+  static constexpr void write(W& out, const Node& node, uint8_t flags) {
+    using enum encoding::NodeKind;
+
+    if constexpr (IsReq<Node>::value) {
+      write(out, static_cast<const typename Node::Type&>(node), flags | encoding::required);
+    } else if constexpr (IsMutEx<Node>::value) {
+      out.node(mutex, flags);
+      out.nodes(std::tuple_size_v<decltype(node.group)>);
+
+      template_for(node.group, [&]<class MutExNode>(const MutExNode& mutex_node) {
+        write(out, mutex_node, 0);
+      });
+
+      out.end_nodes();
+      out.end_node();
+    } else if constexpr (IsCmd<Node>::value) {
+      out.node(cmd, flags);
+      out.keys(Meta<Node>::keys());
+      write(out, node.parser);
+      out.end_node();
+    } else {
+      out.node(IsOpt<Node>::value ? opt : IsQty<Node>::value ? qty : IsArg<Node>::value ? arg : pos, flags);
+      out.keys(Meta<Node>::keys());
+
+      if constexpr (IsArg<Node>::value || IsPos<Node>::value)
+        out.type(value_type<Node>(), value_size<Node>());
+
+      if constexpr (IsConstrainedArg<Node>::value)
+        out.choices(node.choices);
+      else if constexpr (IsArg<Node>::value)
+        out.choices({});
+
+      out.end_node();
+    }
+  }
+
+  /// The type a bound node's value is converted to, as by assign_value
+  template<class Node>
+  static constexpr encoding::ValueType value_type() {
+    using enum encoding::ValueType;
+
+    if constexpr (IsBound<Node>::value) {
+      using V = typename Node::Binding::Type;
+
+      if constexpr (std::is_assignable_v<V&, std::string_view>)
+        return string;
+      else if constexpr (std::is_floating_point_v<V>)
+        return floating_point;
+      else if constexpr (std::is_signed_v<V>)
+        return signed_integer;
+      else
+        return unsigned_integer;
+    }
+
+    return string;
+  }
+
+  template<class Node>
+  static constexpr uint8_t value_size() {
+    if constexpr (IsBound<Node>::value && value_type<Node>() != encoding::ValueType::string)
+      return sizeof(typename Node::Binding::Type);
+
+    return 0;
+  }
+};
+
+/// Writes a schema in the binary encoding described in arp/encoding.hpp
+class BinaryWriter final {
+  std::vector<uint8_t> m_bytes;
+
+  constexpr void u16(size_t value) {
+    if (value > UINT16_MAX)
+      throw std::length_error("schema count or string size exceeds 65535");
+
+    m_bytes.push_back(static_cast<uint8_t>(value));
+    m_bytes.push_back(static_cast<uint8_t>(value >> 8));
+  }
+
+  constexpr void string(std::string_view str) {
+    u16(str.size());
+    m_bytes.insert(m_bytes.end(), str.begin(), str.end());
+  }
+
+public:
+  constexpr BinaryWriter()
+    : m_bytes(encoding::magic.begin(), encoding::magic.end())
+  {
+    m_bytes.push_back(encoding::version);
+  }
+
+  constexpr void nodes(size_t count) { u16(count); }
+  constexpr void end_nodes() {}
+
+  constexpr void node(encoding::NodeKind kind, uint8_t flags) {
+    m_bytes.push_back(static_cast<uint8_t>(kind));
+    m_bytes.push_back(flags);
+  }
+
+  constexpr void end_node() {}
+
+  constexpr void keys(std::span<const std::string_view> keys) {
+    u16(keys.size());
+
+    for (auto key: keys)
+      string(key);
+  }
+
+  constexpr void type(encoding::ValueType type, uint8_t size) {
+    m_bytes.push_back(static_cast<uint8_t>(type));
+    m_bytes.push_back(size);
+  }
+
+  constexpr void choices(std::span<const char* const> choices) {
+    u16(choices.size());
+
+    for (auto choice: choices)
+      string(choice);
+  }
+
+  constexpr std::vector<uint8_t> result() && { return std::move(m_bytes); }
+};
+
+/// Writes a schema as JSON, e.g.
+/// {"version":1,"nodes":[{"kind":"arg","keys":["s","std"],"type":"string","choices":["17","20"]}]}
+class JsonWriter final {
+  std::string m_json;
+
+  constexpr void number(size_t value) {
+    if (value >= 10)
+      number(value / 10);
+
+    m_json += static_cast<char>('0' + value % 10);
+  }
+
+  constexpr void string(std::string_view str) {
+    constexpr std::string_view hex = "0123456789abcdef";
+
+    m_json += '"';
+
+    for (char c: str) {
+      if (c == '"' || c == '\\')
+        m_json += {'\\', c};
+      else if (static_cast<unsigned char>(c) < 0x20)
+        m_json += {'\\', 'u', '0', '0', hex[(c >> 4) & 0xF], hex[c & 0xF]};
+      else
+        m_json += c;
+    }
+
+    m_json += '"';
+  }
+
+  template<class R>
+  constexpr void strings(std::string_view name, const R& range) {
+    m_json += ",\"" + std::string(name) + "\":[";
+
+    for (std::string_view str: range) {
+      if (m_json.back() != '[')
+        m_json += ',';
+      string(str);
+    }
+
+    m_json += ']';
+  }
+
+public:
+  constexpr JsonWriter()
+    : m_json("{\"version\":")
+  {
+    number(encoding::version);
+  }
+
+  constexpr void nodes(size_t) { m_json += ",\"nodes\":["; }
+  constexpr void end_nodes() { m_json += ']'; }
+
+  constexpr void node(encoding::NodeKind kind, uint8_t flags) {
+    constexpr std::array<std::string_view, 7> names = {"", "opt", "qty", "arg", "pos", "cmd", "mutex"};
+
+    if (m_json.back() != '[')
+      m_json += ',';
+
+    m_json += "{\"kind\":\"" + std::string(names[static_cast<size_t>(kind)]) + "\"";
+
+    if (flags & encoding::required)
+      m_json += ",\"required\":true";
+  }
+
+  constexpr void end_node() { m_json += '}'; }
+
+  constexpr void keys(std::span<const std::string_view> keys) { strings("keys", keys); }
+
+  constexpr void type(encoding::ValueType type, uint8_t size) {
+    constexpr std::array<std::string_view, 4> names = {"string", "signed", "unsigned", "float"};
+
+    m_json += ",\"type\":\"" + std::string(names[static_cast<size_t>(type)]) + "\"";
+
+    if (size) {
+      m_json += ",\"size\":";
+      number(size);
+    }
+  }
+
+  constexpr void choices(std::span<const char* const> choices) {
+    if (!choices.empty())
+      strings("choices", choices);
+  }
+
+  constexpr std::string result() && { return std::move(m_json) + '}'; }
+};
+
+template<class W, auto F>
+constexpr auto write_schema() {
+  W out;
+  Schema::write(out, F());
+  return std::move(out).result();
+}
+
+/// The schema of the parser returned by F, in the binary encoding read by
+/// Validator. F must be usable in a constant expression, e.g. a captureless
+/// lambda or a function returning the parser.
+template<auto F>
+consteval auto schema() {
+  std::array<uint8_t, write_schema<BinaryWriter, F>().size()> result{};
+  std::ranges::copy(write_schema<BinaryWriter, F>(), result.begin());
+  return result;
+}
+
+/// The schema of the parser returned by F as JSON, without a null terminator
+template<auto F>
+consteval auto schema_json() {
+  std::array<char, write_schema<JsonWriter, F>().size()> result{};
+  std::ranges::copy(write_schema<JsonWriter, F>(), result.begin());
+  return result;
+}
+
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace arp
+{
+
+/// Strings longer than this are neither suggested nor given suggestions
+inline constexpr size_t max_suggestion_size = 64;
+
+/// The largest edit distance at which a string is suggested for a query
+constexpr size_t suggestion_tolerance(std::string_view query) {
+  return query.size() < 2 ? 0 : std::max<size_t>(1, query.size() / 3);
+}
+
+/// The optimal string alignment distance between two strings of at most
+/// max_suggestion_size characters, or limit + 1 if it exceeds limit. This is
+/// the Levenshtein distance with a transposition of adjacent characters
+/// counted as one edit, so that "qiuet" is one edit from "quiet".
+constexpr size_t edit_distance(std::string_view a, std::string_view b, size_t limit) {
+  if (a.size() < b.size())
+    std::swap(a, b);
+
+  if (a.size() - b.size() > limit || b.size() > max_suggestion_size)
+    return limit + 1;
+
+  // Cells further than limit from the diagonal exceed it, so only the band
+  // around the diagonal is computed, and every cell is capped at limit + 1.
+  // A transposition reads the row before the previous one.
+  std::array<std::array<size_t, max_suggestion_size + 1>, 3> rows;
+  auto* before = &rows[0];
+  auto* above = &rows[1];
+  auto* row = &rows[2];
+
+  for (size_t j = 0; j <= b.size(); ++j)
+    (*above)[j] = std::min(j, limit + 1);
+
+  for (size_t i = 1; i <= a.size(); ++i) {
+    size_t first = i > limit ? i - limit : 1;
+    size_t last = std::min(b.size(), i + limit);
+    size_t smallest = (*row)[first - 1] = first == 1 ? std::min(i, limit + 1) : limit + 1;
+
+    for (size_t j = first; j <= last; ++j) {
+      size_t cell = std::min(std::min((*above)[j], (*row)[j - 1]) + 1, (*above)[j - 1] + (a[i - 1] != b[j - 1]));
+
+      if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+        cell = std::min(cell, (*before)[j - 2] + 1);
+
+      (*row)[j] = std::min(cell, limit + 1);
+      smallest = std::min(smallest, (*row)[j]);
+    }
+
+    // The next row reads one cell past this row's band
+    if (last < b.size())
+      (*row)[last + 1] = limit + 1;
+
+    // Every later row is at least the smallest entry of this one, since a
+    // transposition costs no less than the substitution before it
+    if (smallest > limit)
+      return limit + 1;
+
+    std::swap(before, above);
+    std::swap(above, row);
+  }
+
+  return (*above)[b.size()];
+}
+
+/// The nearest of a range of candidates to a query, within the query's
+/// tolerance, or nothing. Ties go to the earliest candidate.
+template<class R>
+constexpr std::string_view nearest(const R& candidates, std::string_view query) {
+  std::string_view best;
+
+  if (query.size() > max_suggestion_size)
+    return best;
+
+  for (size_t limit = suggestion_tolerance(query); std::string_view candidate: candidates) {
+    if (candidate.size() > max_suggestion_size)
+      continue;
+
+    if (size_t distance = edit_distance(query, candidate, limit); distance <= limit) {
+      best = candidate;
+
+      if (distance == 0)
+        break;
+
+      limit = distance - 1;
+    }
+  }
+
+  return best;
+}
+
+/// The set of characters in a string, folded into 64 bits. Each character
+/// in one string but not another takes an edit, and one substitution removes
+/// at most one such character from each side, so the larger of the two
+/// differences is a lower bound on the edit distance. A transposition
+/// changes neither set, and folding only merges characters, which keeps it
+/// a lower bound.
+constexpr uint64_t char_set(std::string_view str) {
+  uint64_t set = 0;
+
+  for (char c: str)
+    set |= uint64_t(1) << (static_cast<unsigned char>(c) % 64);
+
+  return set;
+}
+
+/// Whether more than n bits are set. Tolerances are small, so this is
+/// cheaper than a popcount where the target lacks an instruction for it.
+constexpr bool more_bits_than(uint64_t bits, size_t n) {
+  for (; bits && n; --n)
+    bits &= bits - 1;
+
+  return bits != 0;
+}
+
+/// An index over a fixed set of strings, built at compile time, that finds
+/// the same string as `nearest` over the strings in order. Most strings are
+/// ruled out by their length and character set without computing an edit
+/// distance.
+template<size_t N>
+class SuggestionIndex final {
+  std::array<std::string_view, N> m_strings;
+  std::array<uint64_t, N> m_char_sets{};
+  std::array<uint8_t, N> m_sizes{};  // Apart from the strings, so the filter reads less
+
+public:
+  consteval SuggestionIndex(std::array<std::string_view, N> strings)
+    : m_strings(strings)
+  {
+    for (size_t i = 0; i < N; ++i) {
+      if (m_strings[i].size() > max_suggestion_size)
+        throw std::length_error("string longer than max_suggestion_size");
+
+      m_char_sets[i] = char_set(m_strings[i]);
+      m_sizes[i] = static_cast<uint8_t>(m_strings[i].size());
+    }
+  }
+
+  constexpr std::string_view nearest(std::string_view query) const {
+    std::string_view best;
+
+    if (query.size() > max_suggestion_size)
+      return best;
+
+    uint64_t query_set = char_set(query);
+
+    for (size_t i = 0, limit = suggestion_tolerance(query); i < N; ++i) {
+      size_t length = std::max<size_t>(query.size(), m_sizes[i]) - std::min<size_t>(query.size(), m_sizes[i]);
+
+      if (length > limit
+          || more_bits_than(query_set & ~m_char_sets[i], limit)
+          || more_bits_than(m_char_sets[i] & ~query_set, limit))
+        continue;
+
+      if (size_t distance = edit_distance(query, m_strings[i], limit); distance <= limit) {
+        best = m_strings[i];
+
+        if (distance == 0)
+          break;
+
+        limit = distance - 1;
+      }
+    }
+
+    return best;
+  }
+};
+
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <optional>
 #include <span>
 #include <stdexcept>
@@ -9,12 +11,6 @@
 namespace arp
 {
 
-constexpr std::span<const char* const> consume_all(std::span<const char* const>& span) {
-  auto copy = span;
-  span = {};
-  return copy;
-}
-
 constexpr std::string_view consume_token(std::span<const char* const>& span) {
   if (span.empty())
     throw std::runtime_error("cannot consume from empty span");
@@ -38,4 +34,114 @@ constexpr std::optional<std::string_view> try_consume_token(std::string_view tok
   return std::nullopt;
 }
 
+/// An argument token, classified once before it is dispatched to the nodes
+struct Token final {
+  enum Kind {
+    empty,      // Skipped
+    separator,  // "--", after which every token is a positional
+    long_key,   // "--key" or "--key=value"
+    short_keys, // "-k", or a cluster such as "-abc" or "-ovalue"
+    word,       // A subcommand or positional
+  };
+
+  Kind kind = empty;
+  std::string_view key;                  // Without its dashes, or the whole word
+  std::optional<std::string_view> value; // Given after '=' to a long key
+};
+
+/// Classify a token by its leading dashes. Only a long key is scanned,
+/// and only as far as its first '='.
+constexpr Token classify_token(std::string_view token) {
+  Token result;
+
+  if (token.empty())
+    return result;
+
+  if (token.size() < 2 || token[0] != '-') {
+    result.kind = Token::word;
+    result.key = token;
+  } else if (token[1] != '-') {
+    result.kind = Token::short_keys;
+    result.key = token.substr(1);
+  } else if (token.size() == 2) {
+    result.kind = Token::separator;
+  } else {
+    result.kind = Token::long_key;
+    result.key = token.substr(2);
+
+    if (auto k = result.key.find('='); k != std::string_view::npos) {
+      result.value = result.key.substr(k + 1);
+      result.key = result.key.substr(0, k);
+    }
+  }
+
+  return result;
+}
+
+/// Writes null-terminated tokens into a caller-supplied character buffer and
+/// records a pointer to each in a caller-supplied argv array, which is kept
+/// null-terminated. Nothing is allocated; if either buffer is exhausted the
+/// writer records an overflow and ignores the remaining output.
+class TokenWriter final {
+  std::span<char> m_chars;
+  std::span<const char*> m_argv;
+  size_t m_size = 0;
+  size_t m_start = 0;
+  size_t m_count = 0;
+  bool m_overflow = false;
+
+public:
+  constexpr TokenWriter(std::span<char> chars, std::span<const char*> argv)
+    : m_chars(chars)
+    , m_argv(argv)
+  {
+    if (m_argv.empty())
+      m_overflow = true;
+    else
+      m_argv.front() = nullptr;
+  }
+
+  constexpr size_t count() const { return m_count; }
+  constexpr bool overflow() const { return m_overflow; }
+
+  /// Begin a token at the current position
+  constexpr void begin() {
+    m_start = m_size;
+  }
+
+  constexpr void append(std::string_view str) {
+    if (m_overflow || m_chars.size() - m_size < str.size()) {
+      m_overflow = true;
+      return;
+    }
+
+    std::ranges::copy(str, m_chars.begin() + m_size);
+    m_size += str.size();
+  }
+
+  constexpr void append(char c) {
+    append(std::string_view(&c, 1));
+  }
+
+  /// Terminate the current token and record it in argv
+  constexpr void end() {
+    append('\0');
+
+    if (m_overflow || m_argv.size() - m_count < 2) {
+      m_overflow = true;
+      return;
+    }
+
+    m_argv[m_count++] = m_chars.data() + m_start;
+    m_argv[m_count] = nullptr;
+  }
+
+  template<class... S>
+  constexpr void push(const S&... parts) {
+    begin();
+    (..., append(parts));
+    end();
+  }
+};
+
 }
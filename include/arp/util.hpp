@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstddef>
+#include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
 
@@ -26,4 +28,12 @@ constexpr void template_for(const std::tuple<T...>& tuple, F&& fn) {
   std::apply([&](auto&... x) { (..., std::forward<F>(fn)(x)); }, tuple);
 }
 
+template<class... S>
+constexpr std::string join(std::string_view separator, const S&... parts) {
+  std::string result;
+  size_t count = 0;
+  (..., result.append(count++ ? separator : std::string_view()).append(parts));
+  return result;
+}
+
 }
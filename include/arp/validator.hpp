@@ -0,0 +1,512 @@
+#pragma once
+
+#include <arp/encoding.hpp>
+#include <arp/error.hpp>
+#include <arp/suggest.hpp>
+#include <arp/tokens.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace arp
+{
+
+/// Validates arguments against a schema in the binary encoding produced by
+/// arp/schema.hpp, reporting the errors that Parser::parse would report,
+/// without the parser's types. Like the parser, it does not yet enforce Req
+/// or MutEx groups, which are described by the schema for other consumers.
+class Validator final {
+  using NodeKind = encoding::NodeKind;
+  using ValueType = encoding::ValueType;
+
+  static constexpr size_t max_depth = 64;
+
+  /// A string in the schema, by offset
+  struct String {
+    uint32_t offset = 0;
+    uint16_t size = 0;
+  };
+
+  struct Node {
+    NodeKind kind{};
+    uint8_t flags = 0;
+    ValueType type = ValueType::string;
+    uint8_t size = 0;
+    uint32_t keys = 0;       // Index of the node's first key in m_strings
+    uint16_t key_count = 0;
+    uint32_t choices = 0;    // Index of the node's first choice in m_strings
+    uint16_t choice_count = 0;
+    uint32_t scope = 0;      // The scope of a Cmd's parser
+  };
+
+  /// The nodes of one parser. Opts, Qtys and Args, including those in
+  /// MutEx groups, are matched by key in declaration order, Cmds by key,
+  /// and Pos nodes are filled in order.
+  struct Scope {
+    std::vector<Node> keyed;
+    std::vector<Node> commands;
+    std::vector<Node> positionals;
+  };
+
+  class Reader {
+    std::span<const uint8_t> m_bytes;
+    size_t m_offset = 0;
+    bool m_ok = true;
+
+  public:
+    explicit Reader(std::span<const uint8_t> bytes)
+      : m_bytes(bytes)
+    {}
+
+    bool ok() const { return m_ok; }
+    bool done() const { return m_offset == m_bytes.size(); }
+
+    uint8_t u8() {
+      if (m_offset == m_bytes.size()) {
+        m_ok = false;
+        return 0;
+      }
+
+      return m_bytes[m_offset++];
+    }
+
+    uint16_t u16() {
+      uint16_t lo = u8();
+      return static_cast<uint16_t>(lo | u8() << 8);
+    }
+
+    String string() {
+      uint16_t size = u16();
+
+      if (m_offset + size > m_bytes.size()) {
+        m_ok = false;
+        return {};
+      }
+
+      m_offset += size;
+      return {static_cast<uint32_t>(m_offset - size), size};
+    }
+  };
+
+  std::vector<uint8_t> m_schema;
+  std::vector<String> m_strings;
+  std::vector<Scope> m_scopes;
+
+  Validator() = default;
+
+  std::string_view str(String s) const {
+    return {reinterpret_cast<const char*>(m_schema.data()) + s.offset, s.size};
+  }
+
+  std::string_view key(const Node& node, size_t k) const { return str(m_strings[node.keys + k]); }
+  std::string_view choice(const Node& node, size_t k) const { return str(m_strings[node.choices + k]); }
+
+  bool decode_nodes(Reader&, size_t scope, size_t depth, bool in_mutex);
+  bool decode_strings(Reader&, uint32_t& first, uint16_t& count);
+  bool decode_type(Reader&, Node&);
+
+  template<size_t N>
+  void validate_tokens(size_t scope, std::span<const char* const>&, size_t argc, ParserErrors<N>&) const;
+
+  std::optional<ParserError> validate_double_type(size_t scope, const Token&, std::span<const char* const>&) const;
+  std::optional<ParserError> validate_single_type(size_t scope, std::string_view keys, std::span<const char* const>&) const;
+  std::optional<ParserError> validate_pos(size_t scope, std::string_view token, size_t& filled) const;
+  std::string suggest_key(size_t scope, std::string_view key) const;
+  std::string suggest_command(size_t scope, std::string_view key) const;
+
+  template<class F>
+  std::optional<ParserError> validate_node(const Node&, std::string_view key, F&& consume_value) const;
+
+  std::optional<ParserError> validate_value(const Node&, std::string_view value) const;
+
+  const Node* find_key(size_t scope, std::string_view key) const;
+
+  std::string id(const Node&) const;
+
+  static bool converts(const Node&, std::string_view value);
+
+public:
+  /// Decode a schema, which is copied. Returns nothing if the schema is malformed.
+  static std::optional<Validator> load(std::span<const uint8_t> schema);
+
+  /// Validate an array of tokenised arguments, as Parser::parse would parse them
+  std::optional<ParserError> validate(std::span<const char* const> args) const;
+
+  /// Validate an array of tokenised arguments, recording each error as
+  /// Parser::parse would with an error list
+  template<size_t N>
+  void validate(std::span<const char* const> args, ParserErrors<N>& errors) const;
+};
+
+inline std::optional<Validator> Validator::load(std::span<const uint8_t> schema) {
+  Validator validator;
+  validator.m_schema.assign(schema.begin(), schema.end());
+  validator.m_scopes.emplace_back();
+
+  Reader in(validator.m_schema);
+
+  for (uint8_t byte: encoding::magic)
+    if (in.u8() != byte)
+      return std::nullopt;
+
+  if (in.u8() != encoding::version)
+    return std::nullopt;
+
+  if (!validator.decode_nodes(in, 0, 0, false) || !in.ok() || !in.done())
+    return std::nullopt;
+
+  return validator;
+}
+
+/// Scopes are appended as Cmds are decoded, so a scope is always
+/// indexed rather than held by reference
+inline bool Validator::decode_nodes(Reader& in, size_t scope, size_t depth, bool in_mutex) {
+  if (depth > max_depth)
+    return false;
+
+  for (uint16_t count = in.u16(); count > 0 && in.ok(); --count) {
+    Node node{.kind = static_cast<NodeKind>(in.u8())};
+    node.flags = in.u8();
+
+    switch (node.kind) {
+      case NodeKind::opt:
+      case NodeKind::qty:
+        if (!decode_strings(in, node.keys, node.key_count) || !node.key_count)
+          return false;
+
+        m_scopes[scope].keyed.push_back(node);
+        break;
+
+      case NodeKind::arg:
+        if (!decode_strings(in, node.keys, node.key_count) || !node.key_count || !decode_type(in, node)
+            || !decode_strings(in, node.choices, node.choice_count))
+          return false;
+
+        m_scopes[scope].keyed.push_back(node);
+        break;
+
+      case NodeKind::pos:
+        if (in_mutex || !decode_strings(in, node.keys, node.key_count) || node.key_count != 1 || !decode_type(in, node))
+          return false;
+
+        m_scopes[scope].positionals.push_back(node);
+        break;
+
+      case NodeKind::cmd:
+        if (in_mutex || !decode_strings(in, node.keys, node.key_count) || node.key_count != 1)
+          return false;
+
+        node.scope = static_cast<uint32_t>(m_scopes.size());
+        m_scopes.emplace_back();
+
+        if (!decode_nodes(in, node.scope, depth + 1, false))
+          return false;
+
+        m_scopes[scope].commands.push_back(node);
+        break;
+
+      case NodeKind::mutex:
+        if (in_mutex || !decode_nodes(in, scope, depth + 1, true))
+          return false;
+        break;
+
+      default:
+        return false;
+    }
+  }
+
+  return in.ok();
+}
+
+inline bool Validator::decode_strings(Reader& in, uint32_t& first, uint16_t& count) {
+  first = static_cast<uint32_t>(m_strings.size());
+  count = in.u16();
+
+  for (size_t k = 0; k < count && in.ok(); ++k)
+    m_strings.push_back(in.string());
+
+  return in.ok();
+}
+
+inline bool Validator::decode_type(Reader& in, Node& node) {
+  node.type = static_cast<ValueType>(in.u8());
+  node.size = in.u8();
+
+  switch (node.type) {
+    case ValueType::string:
+      return node.size == 0;
+    case ValueType::signed_integer:
+    case ValueType::unsigned_integer:
+      return node.size == 1 || node.size == 2 || node.size == 4 || node.size == 8;
+    case ValueType::floating_point:
+      return node.size == sizeof(float) || node.size == sizeof(double) || node.size == sizeof(long double);
+  }
+
+  return false;
+}
+
+inline std::optional<ParserError> Validator::validate(std::span<const char* const> args) const {
+  ParserErrors<1> errors;
+
+  if (validate(args, errors); !errors.empty())
+    return std::move(errors[0]);
+
+  return std::nullopt;
+}
+
+template<size_t N>
+void Validator::validate(std::span<const char* const> args, ParserErrors<N>& errors) const {
+  validate_tokens(0, args, args.size(), errors);
+}
+
+template<size_t N>
+void Validator::validate_tokens(size_t scope, std::span<const char* const>& args, size_t argc, ParserErrors<N>& errors) const {
+  bool parsing_opts = true;
+  size_t filled = 0;
+
+  while (!args.empty() && !errors.full()) {
+    size_t index = argc - args.size();
+    std::string_view raw = consume_token(args);
+    std::optional<ParserError> error;
+
+    if (raw.empty())
+      continue;
+
+    if (!parsing_opts) {
+      error = validate_pos(scope, raw, filled);
+    } else {
+      switch (Token token = classify_token(raw); token.kind) {
+        case Token::separator:
+          parsing_opts = false;
+          break;
+
+        case Token::long_key:
+          error = validate_double_type(scope, token, args);
+          break;
+
+        case Token::short_keys:
+          error = validate_single_type(scope, token.key, args);
+          break;
+
+        default: {
+          const auto& commands = m_scopes[scope].commands;
+          auto cmd = std::ranges::find_if(commands, [&](const Node& node) { return key(node, 0) == raw; });
+
+          if (cmd != commands.end())
+            validate_tokens(cmd->scope, args, argc, errors);
+          else if (error = validate_pos(scope, raw, filled); error && error->err == ParserError::unknown_pos)
+            error->suggestion = suggest_command(scope, raw);
+
+          break;
+        }
+      }
+    }
+
+    if (error) {
+      error->index = index;
+      errors.push(std::move(*error));
+    }
+  }
+}
+
+inline std::optional<ParserError> Validator::validate_double_type(size_t scope, const Token& token, std::span<const char* const>& args) const {
+  std::string_view key = token.key;
+  std::optional<std::string_view> val = token.value;
+  const Node* node = find_key(scope, key);
+
+  if (!node)
+    return ParserError{
+      .err = ParserError::unknown_key,
+      .msg = "unknown key: " + std::string(key),
+      .suggestion = suggest_key(scope, key)
+    };
+
+  return validate_node(*node, key, [&] {
+    return val ? *val : try_consume_token(args);
+  });
+}
+
+inline std::optional<ParserError> Validator::validate_single_type(size_t scope, std::string_view keys, std::span<const char* const>& args) const {
+  bool value_consumed = false;
+
+  while (!value_consumed && !keys.empty()) {
+    std::string_view key = keys.substr(0, 1);
+    std::optional<std::string_view> val;
+
+    if (auto rem = keys.substr(1); !rem.empty()) {
+      if (rem.starts_with('='))
+        rem = keys.substr(2);
+
+      if (!rem.empty())
+        val = rem;
+    }
+
+    const Node* node = find_key(scope, key);
+
+    if (!node)
+      return ParserError{
+        .err = ParserError::unknown_key,
+        .msg = "unknown key: " + std::string(key)
+      };
+
+    if (auto error = validate_node(*node, key, [&] {
+          return value_consumed = true, val ? *val : try_consume_token(args);
+        }))
+      return error;
+
+    keys.remove_prefix(1);
+  }
+
+  return std::nullopt;
+}
+
+inline std::optional<ParserError> Validator::validate_pos(size_t scope, std::string_view token, size_t& filled) const {
+  const auto& positionals = m_scopes[scope].positionals;
+
+  if (filled == positionals.size())
+    return ParserError{
+      .err = ParserError::unknown_pos,
+      .msg = "unknown positional argument: " + std::string(token)
+    };
+
+  return validate_value(positionals[filled++], token);
+}
+
+template<class F>
+std::optional<ParserError> Validator::validate_node(const Node& node, std::string_view key, F&& consume_value) const {
+  if (node.kind != NodeKind::arg)
+    return std::nullopt;
+
+  std::optional<std::string_view> value = consume_value();
+
+  if (!value)
+    return ParserError{
+      .err = ParserError::missing_value,
+      .msg = "value not supplied for arg '" + std::string(key) + "'"
+    };
+
+  return validate_value(node, *value);
+}
+
+inline std::optional<ParserError> Validator::validate_value(const Node& node, std::string_view value) const {
+  if (node.choice_count) {
+    bool found = false;
+    std::string list;
+    std::vector<std::string_view> choices;
+
+    for (size_t k = 0; k < node.choice_count; ++k) {
+      found = found || choice(node, k) == value;
+      list += (k ? ", \"" : "\"") + std::string(choice(node, k)) + "\"";
+      choices.push_back(choice(node, k));
+    }
+
+    if (!found)
+      return ParserError{
+        .err = ParserError::unknown_value,
+        .msg = "value '" + std::string(value) + "' not in choices list: [" + list + "]",
+        .suggestion = std::string(nearest(choices, value))
+      };
+  }
+
+  if (!converts(node, value))
+    return ParserError{
+      .err = ParserError::invalid_value,
+      .msg = "value '" + std::string(value) + "' not valid for " + id(node)
+    };
+
+  return std::nullopt;
+}
+
+/// The nearest long key in the scope to an unknown one, as Parser suggests
+inline std::string Validator::suggest_key(size_t scope, std::string_view key) const {
+  std::vector<std::string_view> keys;
+
+  for (const Node& node: m_scopes[scope].keyed)
+    for (size_t k = 0; k < node.key_count; ++k)
+      if (this->key(node, k).size() > 1)
+        keys.push_back(this->key(node, k));
+
+  if (auto suggestion = nearest(keys, key); !suggestion.empty())
+    return "--" + std::string(suggestion);
+
+  return {};
+}
+
+/// The nearest subcommand in the scope to an unknown positional
+inline std::string Validator::suggest_command(size_t scope, std::string_view key) const {
+  std::vector<std::string_view> keys;
+
+  for (const Node& node: m_scopes[scope].commands)
+    keys.push_back(this->key(node, 0));
+
+  return std::string(nearest(keys, key));
+}
+
+inline auto Validator::find_key(size_t scope, std::string_view key) const -> const Node* {
+  for (const Node& node: m_scopes[scope].keyed)
+    for (size_t k = 0; k < node.key_count; ++k)
+      if (this->key(node, k) == key)
+        return &node;
+
+  return nullptr;
+}
+
+/// The node's identity as Meta<T>::id() gives it, e.g. `Arg<s, std>`,
+/// or `Req<Arg<s, std>>` if it is required
+inline std::string Validator::id(const Node& node) const {
+  std::string id = node.kind == NodeKind::arg ? "Arg<" : "Pos<";
+
+  for (size_t k = 0; k < node.key_count; ++k)
+    id.append(k ? ", " : "").append(key(node, k));
+
+  id += ">";
+  return node.flags & encoding::required ? "Req<" + id + ">" : id;
+}
+
+/// Whether a value converts to a bound node's type, as assign_value converts it
+inline bool Validator::converts(const Node& node, std::string_view value) {
+  auto parses = [&]<class V>(V result) {
+    auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+    return ec == std::errc() && end == value.data() + value.size();
+  };
+
+  switch (node.type) {
+    case ValueType::string:
+      return true;
+
+    case ValueType::signed_integer:
+      switch (node.size) {
+        case 1: return parses(int8_t());
+        case 2: return parses(int16_t());
+        case 4: return parses(int32_t());
+        default: return parses(int64_t());
+      }
+
+    case ValueType::unsigned_integer:
+      switch (node.size) {
+        case 1: return parses(uint8_t());
+        case 2: return parses(uint16_t());
+        case 4: return parses(uint32_t());
+        default: return parses(uint64_t());
+      }
+
+    case ValueType::floating_point:
+      if (node.size == sizeof(float))
+        return parses(float());
+      if (node.size == sizeof(double))
+        return parses(double());
+      return parses(0.0L);
+  }
+
+  return false;
+}
+
+}
@@ -0,0 +1,431 @@
+#include <arp/arp.hpp>
+#include <arp/format.hpp>
+
+#include ARP_REPLAY_SCHEMA
+
+#include <fmt/base.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+/// A read-only view of a regular file mapped into memory. Any failure is
+/// recorded in error(), so that a wrong path never reads as an empty log.
+class MappedFile final {
+  int m_fd = -1;
+  std::string_view m_data;
+  std::string m_error;
+
+public:
+  explicit MappedFile(const char* path) {
+    if (m_fd = ::open(path, O_RDONLY); m_fd < 0) {
+      m_error = std::strerror(errno);
+      return;
+    }
+
+    struct stat st;
+    if (::fstat(m_fd, &st) != 0) {
+      m_error = std::strerror(errno);
+      return;
+    }
+
+    // A pipe or device has no size to map, and a directory no lines
+    if (!S_ISREG(st.st_mode)) {
+      m_error = "not a regular file";
+      return;
+    }
+
+    if (st.st_size == 0)
+      return;
+
+    void* data = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (data == MAP_FAILED) {
+      m_error = std::strerror(errno);
+      return;
+    }
+
+    ::madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+    m_data = {static_cast<const char*>(data), static_cast<size_t>(st.st_size)};
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+    if (!m_data.empty())
+      ::munmap(const_cast<char*>(m_data.data()), m_data.size());
+
+    if (m_fd >= 0)
+      ::close(m_fd);
+  }
+
+  bool ok() const { return m_error.empty(); }
+
+  const std::string& error() const { return m_error; }
+
+  std::string_view data() const { return m_data; }
+};
+
+/// Split the log into chunks of roughly `size` bytes that end on a line boundary
+std::vector<std::string_view> split_chunks(std::string_view data, size_t size) {
+  std::vector<std::string_view> chunks;
+
+  while (!data.empty()) {
+    size_t end = std::min(size, data.size());
+
+    if (auto eol = data.find('\n', end - 1); eol != std::string_view::npos)
+      end = eol + 1;
+    else
+      end = data.size();
+
+    chunks.push_back(data.substr(0, end));
+    data.remove_prefix(end);
+  }
+
+  return chunks;
+}
+
+/// Tokenise a command line in place: whitespace separates tokens and
+/// single or double quotes group whitespace into a token.
+void tokenise(std::string_view line, std::string& buffer, std::vector<const char*>& tokens) {
+  // A spare byte terminates a token that runs to the end of the line, so the
+  // buffer is never resized once pointers into it have been taken
+  buffer.assign(line);
+  buffer.push_back('\0');
+  tokens.clear();
+
+  char quote = 0;
+  bool in_token = false;
+  size_t out = 0;
+
+  for (size_t i = 0; i < line.size(); ++i) {
+    char c = buffer[i];
+
+    if (quote) {
+      if (c == quote)
+        quote = 0;
+      else
+        buffer[out++] = c;
+      continue;
+    }
+
+    if (c == ' ' || c == '\t' || c == '\r') {
+      if (in_token)
+        buffer[out++] = '\0', in_token = false;
+      continue;
+    }
+
+    if (!in_token)
+      tokens.push_back(buffer.data() + out), in_token = true;
+
+    if (c == '"' || c == '\'')
+      quote = c;
+    else
+      buffer[out++] = c;
+  }
+
+  if (in_token)
+    buffer[out] = '\0';
+}
+
+/// Parse cost of the lines whose length falls in [2^k, 2^(k+1))
+struct Cost {
+  size_t lines = 0;
+  size_t bytes = 0;
+  double ns = 0;
+};
+
+/// A line whose parse exceeded the time budget
+struct Overrun {
+  std::string_view line;
+  double ns = 0;
+};
+
+struct alignas(64) Stats {
+  size_t lines = 0;
+  size_t valid = 0;
+  size_t exceptions = 0;
+  size_t bytes = 0;
+  std::array<size_t, 32> errors{};
+  std::array<Cost, 32> costs{};
+  std::vector<Overrun> overruns;
+
+  Stats& operator+=(const Stats& other) {
+    lines += other.lines;
+    valid += other.valid;
+    exceptions += other.exceptions;
+    bytes += other.bytes;
+
+    for (size_t i = 0; i < errors.size(); ++i)
+      errors[i] += other.errors[i];
+
+    for (size_t i = 0; i < costs.size(); ++i) {
+      costs[i].lines += other.costs[i].lines;
+      costs[i].bytes += other.costs[i].bytes;
+      costs[i].ns += other.costs[i].ns;
+    }
+
+    overruns.insert(overruns.end(), other.overruns.begin(), other.overruns.end());
+    return *this;
+  }
+};
+
+/// A worker's contiguous range of chunks. The owner and any thief both
+/// claim from the front, so an idle worker steals whole chunks from a
+/// busy one without a lock.
+struct alignas(64) ChunkQueue {
+  std::atomic<size_t> next = 0;
+  size_t end = 0;
+
+  std::optional<size_t> claim() {
+    if (next.load(std::memory_order_relaxed) >= end)
+      return std::nullopt;
+
+    if (size_t k = next.fetch_add(1, std::memory_order_relaxed); k < end)
+      return k;
+
+    return std::nullopt;
+  }
+};
+
+/// Parse one command line, returning false if the parser threw
+template<class P>
+bool replay_line(const P& prototype, std::vector<const char*>& tokens, Stats& stats) {
+  try {
+    auto parser = prototype;
+
+    if (auto err = parser.parse(static_cast<int>(tokens.size()), tokens.data()))
+      stats.errors[err->err]++;
+    else
+      stats.valid++;
+
+    return true;
+  } catch (const std::exception&) {
+    stats.exceptions++;
+    return false;
+  }
+}
+
+/// The time allowed for any line on top of its budget per byte. It covers
+/// the fixed cost of copying the parser and reading the clock, so that only
+/// a cost that grows with the line's length counts against the budget.
+constexpr double fixed_allowance_ns = 10'000;
+
+/// A line over its budget is timed this many more times, and its fastest
+/// run kept, so that one preemption is not mistaken for a slow parse
+constexpr int retimes = 5;
+
+template<class P>
+double time_line(const P& prototype, std::vector<const char*>& tokens, Stats& stats, bool& ok) {
+  auto start = std::chrono::steady_clock::now();
+  ok = replay_line(prototype, tokens, stats);
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Replay every line of a chunk. With a budget in nanoseconds per byte,
+/// each line is also timed: its cost is recorded by length, and lines whose
+/// cost exceeds the fixed allowance plus the budget for their length are
+/// kept as overruns, as are lines that make the parser throw.
+template<class P>
+void replay_chunk(const P& prototype, std::string_view chunk, double budget, Stats& stats, std::string& buffer, std::vector<const char*>& tokens) {
+  stats.bytes += chunk.size();
+
+  while (!chunk.empty()) {
+    size_t eol = chunk.find('\n');
+    std::string_view line = chunk.substr(0, eol);
+    chunk.remove_prefix(eol == std::string_view::npos ? chunk.size() : eol + 1);
+
+    if (tokenise(line, buffer, tokens); tokens.empty())
+      continue;
+
+    stats.lines++;
+
+    if (budget <= 0) {
+      replay_line(prototype, tokens, stats);
+      continue;
+    }
+
+    bool ok = true;
+    double ns = time_line(prototype, tokens, stats, ok);
+
+    auto& cost = stats.costs[std::bit_width(line.size()) - 1];
+    cost.lines++;
+    cost.bytes += line.size();
+    cost.ns += ns;
+
+    double allowed = fixed_allowance_ns + budget * static_cast<double>(line.size());
+
+    // The re-runs are not counted again
+    for (int run = 0; ok && ns > allowed && run < retimes; ++run) {
+      Stats rerun;
+      ns = std::min(ns, time_line(prototype, tokens, rerun, ok));
+    }
+
+    if (!ok || ns > allowed)
+      stats.overruns.push_back({line, ns});
+  }
+}
+
+template<class N>
+std::optional<N> to_number(std::string_view value) {
+  N result = 0;
+
+  if (auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+      ec != std::errc() || end != value.data() + value.size())
+    return std::nullopt;
+
+  return result;
+}
+
+}
+
+auto main(int argc, const char** argv) -> int {
+  using namespace arp;
+
+  auto cli = Parser{
+    Pos<"log">(),
+    Arg<'j', "jobs">(),
+    Arg<'c', "chunk">(),
+    Arg<'b', "budget">(),
+    Arg<'o', "overruns">(),
+  };
+
+  if (auto err = cli.parse(argc, argv)) {
+    fmt::println(stderr, "error: '{}'", *err);
+    return 1;
+  }
+
+  const auto& log = cli.get<"log">().value;
+  const auto& jobs_arg = cli.get<"jobs">().value;
+  const auto& chunk_arg = cli.get<"chunk">().value;
+  const auto& budget_arg = cli.get<"budget">().value;
+  const auto& overruns_arg = cli.get<"overruns">().value;
+
+  if (log.empty()) {
+    fmt::println(stderr, "usage: arp-replay <log> [-j jobs] [-c chunk-bytes] [-b budget-ns-per-byte] [-o overruns-log]");
+    return 1;
+  }
+
+  auto jobs = jobs_arg.empty() ? std::optional<size_t>(std::max(1u, std::thread::hardware_concurrency())) : to_number<size_t>(jobs_arg);
+  auto chunk_size = chunk_arg.empty() ? std::optional<size_t>(1 << 20) : to_number<size_t>(chunk_arg);
+  auto budget = budget_arg.empty() ? std::optional<double>(0) : to_number<double>(budget_arg);
+
+  if (!jobs || !*jobs || !chunk_size || !*chunk_size) {
+    fmt::println(stderr, "error: jobs and chunk size must be positive integers");
+    return 1;
+  }
+
+  if (!budget || *budget < 0) {
+    fmt::println(stderr, "error: budget must be a non-negative number of nanoseconds per byte");
+    return 1;
+  }
+
+  MappedFile file(std::string(log).c_str());
+
+  if (!file.ok()) {
+    fmt::println(stderr, "error: cannot read '{}': {}", log, file.error());
+    return 1;
+  }
+
+  const auto prototype = replay::schema();
+  const auto chunks = split_chunks(file.data(), *chunk_size);
+  const size_t workers = std::min(*jobs, std::max<size_t>(chunks.size(), 1));
+
+  std::vector<ChunkQueue> queues(workers);
+  std::vector<Stats> stats(workers);
+
+  for (size_t w = 0; w < workers; ++w) {
+    queues[w].next = chunks.size() * w / workers;
+    queues[w].end = chunks.size() * (w + 1) / workers;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(workers);
+
+    for (size_t w = 0; w < workers; ++w) {
+      threads.emplace_back([&, w] {
+        std::string buffer;
+        std::vector<const char*> tokens;
+
+        for (size_t v = 0; v < workers; ++v)
+          while (auto k = queues[(w + v) % workers].claim())
+            replay_chunk(prototype, chunks[*k], *budget, stats[w], buffer, tokens);
+      });
+    }
+  }
+
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  Stats total;
+  for (const auto& s: stats)
+    total += s;
+
+  auto row = [](std::string_view label, const auto& value) {
+    fmt::println("{:<16}{}", fmt::format("{}:", label), value);
+  };
+
+  row("lines", total.lines);
+  row("valid", total.valid);
+
+  for (size_t e = 0; e < total.errors.size(); ++e)
+    if (total.errors[e])
+      row(name(static_cast<ParserError::Enum>(e)), total.errors[e]);
+
+  if (total.exceptions)
+    row("exceptions", total.exceptions);
+
+  if (*budget > 0) {
+    for (size_t k = 0; k < total.costs.size(); ++k)
+      if (const auto& cost = total.costs[k]; cost.lines)
+        row(fmt::format("len {}-{}", size_t(1) << k, (size_t(2) << k) - 1),
+          fmt::format("{:.1f} ns/byte over {} lines", cost.ns / static_cast<double>(cost.bytes), cost.lines));
+
+    row("overruns", total.overruns.size());
+  }
+
+  if (!overruns_arg.empty()) {
+    std::string path(overruns_arg);
+
+    if (auto* out = std::fopen(path.c_str(), "w")) {
+      for (const auto& overrun: total.overruns)
+        fmt::println(out, "{}", overrun.line);
+
+      std::fclose(out);
+    } else {
+      fmt::println(stderr, "error: cannot write '{}'", overruns_arg);
+    }
+  }
+
+  row("threads", workers);
+  row("elapsed", fmt::format("{:.3f} s", elapsed));
+  row("throughput", fmt::format("{:.0f} lines/s, {:.1f} MiB/s",
+    total.lines / elapsed,
+    total.bytes / elapsed / (1 << 20)));
+
+  // A nonzero status lets a script or fuzzer driving the tool notice overruns
+  return total.overruns.empty() ? 0 : 2;
+}
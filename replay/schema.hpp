@@ -0,0 +1,26 @@
+#pragma once
+
+#include <arp/arp.hpp>
+
+namespace arp::replay
+{
+
+/// The interface each logged command line is validated against.
+/// Point ARP_REPLAY_SCHEMA at another header to replay a different CLI.
+inline auto schema() {
+  return Parser{
+    Cmd<"new">(Parser{
+      Pos<"name">(),
+      Arg<'s', "std">({"17", "20", "23", "26"}),
+      Opt<'g', "git">(),
+      Qty<'v'>(),
+      MutEx{
+        Opt<'x', "exe">(),
+        Opt<'l', "lib">(),
+        Opt<'m', "mod">(),
+      },
+    })
+  };
+}
+
+}
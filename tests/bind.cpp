@@ -0,0 +1,95 @@
+#include "check.hpp"
+
+#include <arp/arp.hpp>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace arp;
+
+struct Config {
+  bool quiet = false;
+  int verbose = 0;
+  std::string_view output;
+  std::string name;
+  unsigned jobs = 1;
+  double ratio = 0.25;
+  std::string_view std;
+};
+
+constexpr auto schema = [] {
+  return Parser{
+    Opt<'q', "quiet">(bind<&Config::quiet>),
+    Qty<'v'>(bind<&Config::verbose>),
+    Arg<'o', "output">(bind<&Config::output>),
+    Arg<'j', "jobs">(bind<&Config::jobs>),
+    Arg<"ratio">(bind<&Config::ratio>),
+    Opt<'g'>(),
+    Cmd<"new">(Parser{
+      Pos<"name">(bind<&Config::name>),
+      Arg<'s', "std">({"17", "20", "23"}, bind<&Config::std>),
+    }),
+  };
+};
+
+/// A Config filled in by one parse, and the parse's error
+struct Result {
+  Config config;
+  std::optional<ParserError> error;
+};
+
+Result parse(std::vector<const char*> args) {
+  Result result;
+  auto parser = schema();
+  result.error = parser.parse(args, result.config);
+  return result;
+}
+
+auto main() -> int {
+  {
+    auto [config, error] = parse({"-qvvv", "-o", "out", "-j", "8", "--ratio=0.5", "-g", "new", "proj", "-s", "20"});
+
+    CHECK(!error);
+    CHECK(config.quiet && config.verbose == 3 && config.output == "out");
+    CHECK(config.jobs == 8 && config.ratio == 0.5);
+    CHECK(config.name == "proj" && config.std == "20");
+  }
+
+  // A value with a valid prefix leaves the member as it was
+  for (auto value: {"8x", "x8", "", "-1", "99999999999", " 8"}) {
+    auto [config, error] = parse({"-o", "out", "-j", value});
+
+    CHECK(error && error->err == ParserError::invalid_value && error->index == 2);
+    CHECK(config.jobs == 1);
+    CHECK(config.output == "out");
+  }
+
+  for (auto value: {"0.5.5", "1e", "nan(", "0x1p"}) {
+    auto [config, error] = parse({"--ratio", value});
+
+    CHECK(error && error->err == ParserError::invalid_value && error->index == 0);
+    CHECK(config.ratio == 0.25);
+  }
+
+  {
+    // A choice is checked before the value is stored
+    auto [config, error] = parse({"new", "p", "-s", "99"});
+
+    CHECK(error && error->err == ParserError::unknown_value && error->index == 2);
+    CHECK(config.name == "p" && config.std.empty());
+  }
+
+  {
+    // A bound parser holds no more than an unbound one
+    auto unbound = Parser{
+      Opt<'q', "quiet">(), Qty<'v'>(), Arg<'o', "output">(), Arg<'j', "jobs">(), Arg<"ratio">(), Opt<'g'>(),
+      Cmd<"new">(Parser{ Pos<"name">(), Arg<'s', "std">({"17", "20", "23"}) }),
+    };
+
+    CHECK(sizeof(schema()) <= sizeof(unbound));
+  }
+
+  return test::status();
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdio>
+
+namespace arp::test
+{
+
+inline int failures = 0;
+
+/// The exit status of a test: nonzero if any check failed
+inline int status() {
+  return failures != 0;
+}
+
+}
+
+/// Report a failed check and carry on, so that one run lists every failure
+#define CHECK(...) \
+  ((__VA_ARGS__) ? void() : (std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #__VA_ARGS__), ++arp::test::failures, void()))
@@ -0,0 +1,139 @@
+#include "check.hpp"
+
+#include <arp/arp.hpp>
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+using namespace arp;
+
+constexpr auto schema = [] {
+  return Parser{
+    Opt<'a', "all">(),
+    Qty<'v', "verbose">(),
+    Arg<'s', "std">({"17", "20", "23", "26"}),
+    Arg<'k'>(),
+    MutEx{
+      Opt<'x', "exe">(),
+      Opt<'l', "lib">(),
+    },
+    Pos<"first">(),
+    Pos<"second">(),
+    Cmd<"new">(Parser{
+      Opt<'g'>(),
+      Pos<"name">(),
+    }),
+  };
+};
+
+struct Emitted {
+  std::array<char, 256> chars;
+  std::array<const char*, 32> argv;
+  std::optional<size_t> count;
+
+  std::span<const char* const> args() const { return {argv.data(), count.value_or(0)}; }
+};
+
+template<Id... K, class P>
+Emitted emit(const P& parser) {
+  Emitted out;
+  out.count = parser.template emit<K...>(out.chars, out.argv);
+  return out;
+}
+
+bool same(std::span<const char* const> a, std::span<const char* const> b) {
+  return std::ranges::equal(a, b, [](std::string_view x, std::string_view y) { return x == y; });
+}
+
+/// Parse, emit, parse the emitted tokens, and require the second emit to
+/// match the first, so the canonical form is a fixed point
+bool round_trip(std::vector<const char*> args) {
+  auto parser = schema();
+
+  if (parser.parse(args))
+    return false;
+
+  auto first = emit(parser);
+  auto reparsed = schema();
+
+  if (!first.count || reparsed.parse(first.args()))
+    return false;
+
+  auto second = emit(reparsed);
+  return second.count && same(first.args(), second.args());
+}
+
+auto main() -> int {
+  CHECK(round_trip({}));
+  CHECK(round_trip({"-avv", "--std=20", "in"}));
+  CHECK(round_trip({"--verbose", "-l", "in", "out", "new", "-g", "name"}));
+  CHECK(round_trip({"-k", "", "in"}));
+  CHECK(round_trip({"--", "-in", "--out"}));
+
+  {
+    auto parser = schema();
+    std::vector<const char*> args = {"-avv", "--std", "23", "-x", "in", "new", "n"};
+    CHECK(!parser.parse(args));
+
+    auto out = emit(parser);
+    std::vector<const char*> expected = {"-avvx", "--std=23", "in", "new", "n"};
+    CHECK(out.count && same(out.args(), expected));
+  }
+
+  {
+    // An empty value for a key without a long form takes its own token
+    auto parser = schema();
+    std::vector<const char*> args = {"-k", ""};
+    CHECK(!parser.parse(args));
+
+    auto out = emit(parser);
+    std::vector<const char*> expected = {"-k", ""};
+    CHECK(out.count && same(out.args(), expected));
+  }
+
+  {
+    // Positionals are filled in order, so one cannot be written alone
+    auto parser = schema();
+    std::vector<const char*> args = {"in", "out", "-a"};
+    CHECK(!parser.parse(args));
+
+    std::vector<const char*> first = {"in"};
+    std::vector<const char*> flags = {"-a"};
+    CHECK(same(emit<"first">(parser).args(), first));
+    CHECK(same(emit<'a'>(parser).args(), flags));
+    CHECK(!emit<"second">(parser).count);
+    CHECK(emit<"first", "second">(parser).count == 2);
+  }
+
+  {
+    // Buffers too small for the result
+    auto parser = schema();
+    std::vector<const char*> args = {"-a", "in"};
+    CHECK(!parser.parse(args));
+
+    std::array<char, 4> chars;
+    std::array<const char*, 8> argv;
+    CHECK(!parser.emit(chars, argv));
+
+    std::array<char, 64> more_chars;
+    std::array<const char*, 2> argv_for_one;
+    CHECK(!parser.emit(more_chars, argv_for_one));
+  }
+
+  {
+    // An empty result needs no characters, only the terminating null pointer
+    auto parser = schema();
+    std::vector<const char*> args = {"-a"};
+    CHECK(!parser.parse(args));
+
+    std::array<const char*, 1> argv;
+    CHECK(parser.emit<"first">({}, argv) == 0 && !argv[0]);
+    CHECK(schema().emit({}, argv) == 0);
+  }
+
+  return test::status();
+}
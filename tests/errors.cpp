@@ -0,0 +1,88 @@
+#include "check.hpp"
+
+#include <arp/arp.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace arp;
+
+constexpr auto schema = [] {
+  return Parser{
+    Qty<"verbose">(),
+    Arg<'o'>(),
+    Pos<"first">(),
+    Cmd<"new">(Parser{
+      Pos<"name">(),
+      Arg<'s', "std">({"17", "20", "23", "26"}),
+      Opt<'g'>(),
+    }),
+  };
+};
+
+template<size_t N>
+bool indices(const ParserErrors<N>& errors, std::vector<size_t> expected) {
+  return std::ranges::equal(errors, expected, {}, &ParserError::index);
+}
+
+auto main() -> int {
+  std::vector<const char*> args = {
+    "--bogus", "-o", "a", "f", "g", "-vz", "new", "n", "-s", "99", "m", "-gq", "--std",
+  };
+
+  {
+    // Every error is collected, at the index of the token that caused it
+    auto parser = schema();
+    ParserErrors<8> errors;
+    parser.parse(args, errors);
+
+    CHECK(errors.size() == 7 && !errors.full());
+    CHECK(indices(errors, {0, 4, 5, 8, 10, 11, 12}));
+    CHECK(errors[0].err == ParserError::unknown_key);
+    CHECK(errors[1].err == ParserError::unknown_pos);
+    CHECK(errors[3].err == ParserError::unknown_value);
+    CHECK(errors[6].err == ParserError::missing_value);
+    CHECK(!parser.get<"new">().invoked);
+  }
+
+  {
+    // Parsing stops once the list is full
+    auto parser = schema();
+    ParserErrors<3> errors;
+    parser.parse(args, errors);
+
+    CHECK(errors.full());
+    CHECK(indices(errors, {0, 4, 5}));
+  }
+
+  {
+    // The single-error overload reports the first
+    auto parser = schema();
+    auto error = parser.parse(args);
+
+    CHECK(error && error->err == ParserError::unknown_key && error->index == 0);
+  }
+
+  {
+    // A value consumed for an Arg is skipped, and empty tokens still count
+    auto parser = schema();
+    ParserErrors<4> errors;
+    std::vector<const char*> positionals = {"-o", "--bogus", "", "a", "b", "c"};
+    parser.parse(positionals, errors);
+
+    CHECK(indices(errors, {4, 5}));
+    CHECK(parser.get<'o'>().value == "--bogus");
+  }
+
+  {
+    auto parser = schema();
+    ParserErrors<4> errors;
+    std::vector<const char*> valid = {"--verbose", "-o", "a", "f", "new", "n", "-s", "20"};
+    parser.parse(valid, errors);
+
+    CHECK(errors.empty());
+    CHECK(parser.get<"new">().invoked);
+  }
+
+  return test::status();
+}
@@ -0,0 +1,69 @@
+#include "check.hpp"
+
+#include <arp/arp.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace arp;
+
+// Each handler appends its name, so a check sees both which ran and in what order
+std::string called;
+
+constexpr auto schema = [] {
+  return Parser{
+    Cmd<"new">(
+      Parser{
+        Opt<'g'>([] { called += "g "; }),
+        Cmd<"lib">(Parser{Pos<"name">()}, [] { called += "lib "; }),
+      },
+      [](auto& node) { called += node.parser.template get<'g'>().status ? "new(g) " : "new "; }),
+    Opt<'a'>([] { called += "a "; }),
+    MutEx{
+      Opt<'x'>([] { called += "x "; }),
+      Opt<'y'>([](auto& node) { called += node.status ? "y(set) " : "y "; }),
+    },
+    Req(Opt<'r'>([] { called += "r "; })),
+    Arg<'o'>(),
+  };
+};
+
+bool handled(std::vector<const char*> args, const std::string& expected) {
+  called.clear();
+  auto parser = schema();
+  parser.parse(args);
+  return called == expected;
+}
+
+auto main() -> int {
+  // Only the handlers of set Opts and invoked Cmds fire
+  CHECK(handled({"-r"}, "r "));
+  CHECK(handled({"-r", "-a", "-o", "v"}, "a r "));
+
+  // Opt handlers fire before Cmd handlers, and a subcommand's handlers
+  // before its Cmd's, so the Cmd handler sees its flags already handled
+  CHECK(handled({"-a", "-r", "new", "lib", "n"}, "a r lib new "));
+  CHECK(handled({"new", "-g", "lib", "n"}, "g lib new(g) "));
+
+  // A handler may take its node, or nothing
+  CHECK(handled({"-r", "-y"}, "y(set) r "));
+  CHECK(handled({"-r", "-x"}, "x r "));
+
+  // No handler fires after an error, including one found after the flags
+  CHECK(handled({"-a", "-x", "-r", "-o"}, ""));
+  CHECK(handled({"-a", "-y", "new", "-g", "--bogus"}, ""));
+  CHECK(handled({"-r", "new", "lib", "n", "extra"}, ""));
+
+  {
+    // Nor when errors are collected rather than returned
+    called.clear();
+    auto parser = schema();
+    std::vector<const char*> args = {"-a", "-r", "-o"};
+    ParserErrors<4> errors;
+    parser.parse(args, errors);
+
+    CHECK(errors.size() == 1 && called.empty());
+  }
+
+  return test::status();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <arp/arp.hpp>
+
+#include <optional>
+#include <span>
+
+namespace arp::test
+{
+
+/// Parse with a fresh parser from the schema F, into a default-constructed
+/// C if the parser's nodes are bound
+template<auto F, class C>
+std::optional<ParserError> parse(std::span<const char* const> args) {
+  auto parser = F();
+
+  if constexpr (requires { parser.parse(args); }) {
+    return parser.parse(args);
+  } else {
+    C target;
+    return parser.parse(args, target);
+  }
+}
+
+}
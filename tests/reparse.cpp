@@ -0,0 +1,103 @@
+#include "check.hpp"
+
+#include <arp/arp.hpp>
+
+#include <memory>
+#include <vector>
+
+using namespace arp;
+
+int handled = 0;
+
+constexpr auto schema = [] {
+  return Parser{
+    Qty<"verbose">(),
+    Arg<'o'>(),
+    Opt<'q'>([] { ++handled; }),
+    Pos<"first">(),
+    Cmd<"new">(Parser{
+      Pos<"name">(),
+    }),
+  };
+};
+
+auto main() -> int {
+  auto parser = schema();
+
+  std::vector<const char*> first = {"-o", "a", "f"};
+  auto changes = parser.reparse(first);
+
+  CHECK(changes.has_value());
+  CHECK(changes->contains<'o'>() && changes->contains<"first">());
+  CHECK(!changes->contains<"verbose">() && !changes->contains<"new">());
+
+  // The same arguments change nothing
+  changes = parser.reparse(first);
+  CHECK(changes.has_value() && changes->empty());
+
+  std::vector<const char*> second = {"--verbose", "-o", "b", "f", "new", "n"};
+  changes = parser.reparse(second);
+
+  CHECK(changes.has_value());
+  CHECK(changes->contains<"verbose">() && changes->contains<'o'>() && changes->contains<"new">());
+  CHECK(!changes->contains<"first">() && !changes->contains<'q'>());
+  CHECK(changes->previous.get<'o'>().value == "a");
+  CHECK(parser.get<'o'>().value == "b");
+
+  // A nested change marks its Cmd
+  std::vector<const char*> third = {"--verbose", "-o", "b", "f", "new", "m"};
+  changes = parser.reparse(third);
+
+  CHECK(changes.has_value());
+  CHECK(changes->contains<"new">() && !changes->contains<'o'>());
+  CHECK(parser.get<"new">().get<"name">().value == "m");
+
+  // A failed reparse keeps the current result
+  std::vector<const char*> bad = {"-o", "c", "--bogus"};
+  changes = parser.reparse(bad);
+
+  CHECK(!changes.has_value());
+  CHECK(changes.error().err == ParserError::unknown_key && changes.error().index == 2);
+  CHECK(parser.get<'o'>().value == "b");
+  CHECK(parser.get<"verbose">().count == 1);
+  CHECK(parser.get<"new">().invoked && parser.get<"new">().get<"name">().value == "m");
+
+  // Handlers are left to the caller
+  std::vector<const char*> quiet = {"-q"};
+  changes = parser.reparse(quiet);
+
+  CHECK(changes.has_value() && changes->contains<'q'>());
+  CHECK(handled == 0);
+
+  {
+    // The previous result holds no handlers, so handlers that capture by
+    // reference or own move-only state neither stop a reparse nor its
+    // result being reassigned
+    int seen = 0;
+    auto owned = std::make_unique<int>(0);
+
+    auto capturing = Parser{
+      Opt<'a'>([&seen] { ++seen; }),
+      Opt<'b'>([owned = std::move(owned)] { ++*owned; }),
+      MutEx{
+        Opt<'x'>(),
+        Opt<'y'>(),
+      },
+      Cmd<"run">(Parser{Arg<'n'>()}, [&seen] { ++seen; }),
+    };
+
+    std::vector<const char*> before = {"-a", "-x", "run", "-n", "1"};
+    std::vector<const char*> after = {"-y", "run", "-n", "2"};
+    auto result = capturing.reparse(before);
+    result = capturing.reparse(after);
+
+    CHECK(result.has_value() && result->contains<'a'>() && result->contains<'y'>() && result->contains<"run">());
+    CHECK(!result->contains<'b'>());
+    CHECK(result->previous.get<'a'>().status && result->previous.get<'x'>().status);
+    CHECK(!result->previous.get<'y'>().status && capturing.get<'y'>().status);
+    CHECK(result->previous.get<"run">().invoked && result->previous.get<"run">().get<'n'>().value == "1");
+    CHECK(seen == 0);
+  }
+
+  return test::status();
+}
@@ -0,0 +1,22 @@
+# Replays one log with several thread counts and chunk sizes. Each run must
+# count exactly what the expected file records, whatever the scheduling.
+file(READ ${EXPECTED} expected)
+
+foreach(options "-j;1" "-j;2;-c;4096" "-j;4;-c;512" "-j;8;-c;128")
+  execute_process(
+    COMMAND ${REPLAY} ${LOG} ${options}
+    OUTPUT_VARIABLE output
+    RESULT_VARIABLE result)
+
+  list(JOIN options " " options)
+
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "arp-replay ${options} exited with ${result}")
+  endif()
+
+  string(REGEX REPLACE "threads:.*" "" counts "${output}")
+
+  if(NOT counts STREQUAL expected)
+    message(FATAL_ERROR "arp-replay ${options} counted\n${counts}instead of\n${expected}")
+  endif()
+endforeach()
@@ -0,0 +1,55 @@
+#include "check.hpp"
+
+#include <arp/arp.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace arp;
+
+constexpr auto schema = [] {
+  return Parser{
+    Opt<'q', "quiet">(),
+    Arg<'s', "std">({"17", "20", "23", "26"}),
+    Pos<"input">(),
+    Cmd<"build">(Parser{
+      Opt<'r', "release">(),
+    }),
+    Cmd<"test">(Parser{}),
+  };
+};
+
+std::string suggestion(std::vector<const char*> args) {
+  auto parser = schema();
+  auto error = parser.parse(args);
+  return error ? error->suggestion : "(none)";
+}
+
+auto main() -> int {
+  static_assert(edit_distance("quiet", "quiet", 1) == 0);
+  static_assert(edit_distance("qiuet", "quiet", 1) == 1);
+  static_assert(edit_distance("sdt", "std", 1) == 1);
+  static_assert(edit_distance("ab", "ba", 0) == 1);
+  static_assert(edit_distance("abc", "ca", 3) == 3);
+  static_assert(edit_distance("release", "relaese", 2) == 1);
+  static_assert(edit_distance("kitten", "sitting", 2) == 3);
+
+  // A transposition is one edit, even in keys too short for two
+  CHECK(suggestion({"--qiuet"}) == "--quiet");
+  CHECK(suggestion({"--sdt=20"}) == "--std");
+  CHECK(suggestion({"--quit"}) == "--quiet");
+  CHECK(suggestion({"--loud"}).empty());
+
+  CHECK(suggestion({"-s", "2O"}) == "20");
+  CHECK(suggestion({"build", "--relaese"}) == "--release");
+
+  // A word past the positionals may be a misspelt subcommand
+  CHECK(suggestion({"in", "biuld"}) == "build");
+  CHECK(suggestion({"in", "tset"}) == "test");
+  CHECK(suggestion({"in", "deploy"}).empty());
+
+  // After "--", words are positionals and never subcommands
+  CHECK(suggestion({"--", "in", "biuld"}).empty());
+
+  return test::status();
+}
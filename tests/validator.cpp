@@ -0,0 +1,133 @@
+#include "check.hpp"
+#include "parse.hpp"
+
+#include <arp/arp.hpp>
+#include <arp/schema.hpp>
+#include <arp/validator.hpp>
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace arp;
+
+struct Config {
+  int jobs = 0;
+  double ratio = 0;
+};
+
+constexpr auto cli = [] {
+  return Parser{
+    Req(Arg<'o', "output">()),
+    Qty<'v', "verbose">(),
+    Opt<'a', "all">(),
+    Req(Pos<"input">()),
+    MutEx{
+      Opt<'x', "exe">(),
+      Opt<'l', "lib">(),
+    },
+    Cmd<"new">(Parser{
+      Pos<"name">(),
+      Arg<'s', "std">({"17", "20", "23", "26"}),
+      Opt<'g'>(),
+    }),
+  };
+};
+
+constexpr auto bound = [] {
+  return Parser{
+    Req(Arg<'j', "jobs">(bind<&Config::jobs>)),
+    Arg<"ratio">(bind<&Config::ratio>),
+  };
+};
+
+const std::vector<std::vector<const char*>> argvs = {
+  {},
+  {"-o", "out", "in"},
+  {"--output=out", "-vva", "in", "new", "n", "--std", "20", "-g"},
+  {"--bogus", "-o"},
+  {"--outptu", "x"},
+  {"--otuput", "x"},
+  {"in", "nwe"},
+  {"--", "in", "nwe"},
+  {"-avz", "in"},
+  {"-o"},
+  {"--output"},
+  {"in", "extra"},
+  {"--", "-in", "--out"},
+  {"new", "n", "--std=2O", "m"},
+  {"new", "-s"},
+  {"", "-", "-x", "-l"},
+  {"-j", "8", "--ratio", "0.5"},
+  {"-j", "8x", "--ratio=1e"},
+  {"--jobs", "", "--jbos"},
+};
+
+bool same(const std::optional<ParserError>& a, const std::optional<ParserError>& b) {
+  if (!a || !b)
+    return !a == !b;
+
+  return a->err == b->err && a->msg == b->msg && a->index == b->index && a->suggestion == b->suggestion;
+}
+
+template<size_t N>
+bool same(const ParserErrors<N>& a, const ParserErrors<N>& b) {
+  if (a.size() != b.size())
+    return false;
+
+  for (size_t i = 0; i < a.size(); ++i)
+    if (!same(a[i], b[i]))
+      return false;
+
+  return true;
+}
+
+/// The parser and the validator over its exported schema must report the
+/// same first error for every argv, and the same collected errors where the
+/// parser can collect them
+template<auto F>
+void check_parity() {
+  static constexpr auto binary = schema<F>();
+  auto validator = Validator::load(binary);
+  CHECK(validator.has_value());
+
+  if (!validator)
+    return;
+
+  for (const auto& args: argvs) {
+    CHECK(same(test::parse<F, Config>(args), validator->validate(args)));
+
+    if constexpr (requires (decltype(F()) parser, ParserErrors<4> errors) { parser.parse(args, errors); }) {
+      auto parser = F();
+      ParserErrors<4> parsed, validated;
+
+      parser.parse(args, parsed);
+      validator->validate(args, validated);
+      CHECK(same(parsed, validated));
+    }
+  }
+}
+
+auto main() -> int {
+  check_parity<cli>();
+  check_parity<bound>();
+
+  // Req nodes parse as the nodes they wrap, and are exported as required
+  auto parser = cli();
+  std::vector<const char*> args = {"-o", "out", "in"};
+  CHECK(!parser.parse(args));
+  CHECK(parser.get<"output">().value == "out" && parser.get<"input">().value == "in");
+
+  static constexpr auto json = schema_json<cli>();
+  std::string_view text(json.data(), json.size());
+  size_t required = 0;
+
+  for (size_t at = 0; (at = text.find("\"required\":true", at)) != std::string_view::npos; ++at)
+    ++required;
+
+  CHECK(required == 2);
+
+  return test::status();
+}